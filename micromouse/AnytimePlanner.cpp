@@ -0,0 +1,237 @@
+#include "AnytimePlanner.h"
+#include "Maze.h"
+#include "Timer.h"
+#include <stdlib.h>
+#include <assert.h>
+
+
+
+
+namespace Micromouse
+{
+	// every move of the search is straight
+	static const direction anytimeDirections[] = { N , E , S , W };
+
+
+
+	template < int WIDTH , int HEIGHT >
+	AnytimePlannerT< WIDTH , HEIGHT >::AnytimePlannerT( const MazeT< WIDTH , HEIGHT >& maze ) :
+		maze( maze ),
+		openList( Geometry::NUM_NODES )
+	{
+		g = new unsigned short[ Geometry::NUM_NODES ];
+		parent = new unsigned short[ Geometry::NUM_NODES ];
+		parentDir = new unsigned char[ Geometry::NUM_NODES ];
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	AnytimePlannerT< WIDTH , HEIGHT >::~AnytimePlannerT()
+	{
+		delete[] g;
+		delete[] parent;
+		delete[] parentDir;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	void AnytimePlannerT< WIDTH , HEIGHT >::start( PositionVector start , PositionVector end , bool isMapping )
+	{
+		startNode = Geometry::getIndex( start.x() , start.y() );
+		endNode = Geometry::getIndex( end.x() , end.y() );
+		this->isMapping = isMapping;
+		started = true;
+
+		restart();
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	bool AnytimePlannerT< WIDTH , HEIGHT >::advance( int maxExpansions , unsigned long maxMicros , unsigned long& nodesExpanded )
+	{
+		if ( !started )
+		{
+			return false;
+		}
+
+		// the nodes changed since the last slice, so the costs may be wrong
+		if ( revision != maze.getRevision() )
+		{
+			restart();
+		}
+
+		Timer timer;
+		float seconds = 0.0f;
+
+		for ( int expanded = 0; !done && expanded < maxExpansions; expanded++ )
+		{
+			if ( expanded > 0 && maxMicros != 0 )
+			{
+				seconds += timer.getDeltaTime();
+
+				if ( seconds * 1000000.0f >= maxMicros )
+				{
+					break;
+				}
+			}
+
+			if ( openList.empty() )
+			{
+				done = true;
+				break;
+			}
+
+			int currentNode = openList.pop();
+			nodesExpanded++;
+
+			closed[ currentNode / 32 ] |= 1u << ( currentNode % 32 );
+
+			if ( currentNode == endNode )
+			{
+				bestNode = endNode;
+				done = true;
+				break;
+			}
+
+			if ( estimateCost( currentNode ) < estimateCost( bestNode ) )
+			{
+				bestNode = currentNode;
+			}
+
+			for ( int d = 0; d < 4; d++ )
+			{
+				int neighborNode = maze.getNeighborIndex( currentNode , anytimeDirections[ d ] );
+
+				if ( neighborNode == MazeT< WIDTH , HEIGHT >::NO_NODE || ( closed[ neighborNode / 32 ] >> ( neighborNode % 32 ) & 1 ) != 0 )
+				{
+					continue;
+				}
+
+				if ( !isMapping && !maze.nodeExplored.get( neighborNode / Geometry::NUM_NODES_H , neighborNode % Geometry::NUM_NODES_H ) )
+				{
+					continue; // Ignore the unexplored nodes if we arent mapping
+				}
+
+				int tentative_G = g[ currentNode ] + STRAIGHT_COST;
+
+				if ( tentative_G >= g[ neighborNode ] )
+				{
+					continue;
+				}
+
+				g[ neighborNode ] = tentative_G;
+				parent[ neighborNode ] = currentNode;
+				parentDir[ neighborNode ] = anytimeDirections[ d ];
+
+				openList.push( neighborNode , tentative_G + estimateCost( neighborNode ) );
+			}
+		}
+
+		return done;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	bool AnytimePlannerT< WIDTH , HEIGHT >::isDone() const
+	{
+		return started && done;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	bool AnytimePlannerT< WIDTH , HEIGHT >::getPath( Path& path ) const
+	{
+		path.clear();
+
+		if ( !started || revision != maze.getRevision() || ( closed[ bestNode / 32 ] >> ( bestNode % 32 ) & 1 ) == 0 )
+		{
+			return false;
+		}
+
+		// the steps are added from the last one back, like MazeT::createPath
+		int node = bestNode;
+
+		while ( node != startNode )
+		{
+			direction dir = static_cast< direction >( parentDir[ node ] );
+			int magnitude = 0;
+
+			while ( node != startNode && parentDir[ node ] == dir && ( magnitude == 0 || !isMapping ) )
+			{
+				node = parent[ node ];
+				magnitude++;
+			}
+
+			path.addStep( DirectionVector( dir , magnitude ) );
+		}
+
+		return bestNode == endNode;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	void AnytimePlannerT< WIDTH , HEIGHT >::updateNode( PositionVector /*pos*/ )
+	{
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	void AnytimePlannerT< WIDTH , HEIGHT >::reset()
+	{
+		started = false;
+		done = false;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	void AnytimePlannerT< WIDTH , HEIGHT >::restart()
+	{
+		for ( int i = 0; i < Geometry::NUM_NODES; i++ )
+		{
+			g[ i ] = INF;
+		}
+
+		for ( int i = 0; i < ( Geometry::NUM_NODES + 31 ) / 32; i++ )
+		{
+			closed[ i ] = 0;
+		}
+
+		openList.clear();
+
+		g[ startNode ] = 0;
+		openList.push( startNode , estimateCost( startNode ) );
+
+		bestNode = startNode;
+		done = false;
+		revision = maze.getRevision();
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	int AnytimePlannerT< WIDTH , HEIGHT >::estimateCost( int index ) const
+	{
+		int dx = index / Geometry::NUM_NODES_H - endNode / Geometry::NUM_NODES_H;
+		int dy = index % Geometry::NUM_NODES_H - endNode % Geometry::NUM_NODES_H;
+
+		return STRAIGHT_COST * ( abs( dx ) + abs( dy ) );
+	}
+
+
+
+	// the classic and the half size competition mazes, only the simulator builds the half size one
+	template class AnytimePlannerT< 16 , 16 >;
+
+#ifdef __MK20DX256__ // Teensy Compile
+#else // PC compile
+	template class AnytimePlannerT< 32 , 32 >;
+#endif
+}
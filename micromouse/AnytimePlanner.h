@@ -0,0 +1,89 @@
+#pragma once
+#include "Vector.h"
+#include "NodeListener.h"
+#include "NodeHeap.h"
+#include "MazeGeometry.h"
+#include "Path.h"
+
+
+
+namespace Micromouse
+{
+	template < int WIDTH , int HEIGHT > class MazeT;
+
+	// An A* search that can be stopped and resumed, for a control loop that cannot wait for findPath.
+	// Each call to advance() expands a bounded number of nodes, or runs for a bounded time, and
+	// returns, so the search is spread over several control ticks. getPath() can be called between
+	// slices and always gives the best path found so far, the whole path once the search is done.
+	//
+	// The search keeps its own costs and open list, so the maze can answer other queries between
+	// slices. A change to the maze makes the costs wrong, so the next slice starts the search again.
+	// The estimate is the Manhattan distance, every move is straight.
+	template < int WIDTH , int HEIGHT >
+	class AnytimePlannerT : public NodeListener
+	{
+	public:
+		typedef MazeGeometry< WIDTH , HEIGHT > Geometry;
+		typedef PathT< Geometry::MAX_PATH_STEPS > Path;
+
+		AnytimePlannerT( const MazeT< WIDTH , HEIGHT >& maze );
+		~AnytimePlannerT();
+
+		// a copy would free the arrays it owns twice
+		AnytimePlannerT( const AnytimePlannerT& ) = delete;
+		AnytimePlannerT& operator=( const AnytimePlannerT& ) = delete;
+
+		// starts a new search from 'start' to 'end', over the explored nodes or every node if 'isMapping'
+		void start( PositionVector start , PositionVector end , bool isMapping );
+
+		// expands at most 'maxExpansions' nodes, and stops early once 'maxMicros' microseconds have
+		// passed if it is not 0, at least one node is expanded so every slice makes progress
+		// returns true if the search is done, 'nodesExpanded' is increased by the nodes expanded
+		bool advance( int maxExpansions , unsigned long maxMicros , unsigned long& nodesExpanded );
+
+		// returns true if a search was started and it reached end or ran out of nodes
+		bool isDone() const;
+
+		// fills 'path' with the path to end if the search found it, or else the path to the node
+		// expanded so far with the lowest estimate to end, empty before the first slice and after
+		// the maze changed, until the next slice, returns true if 'path' reaches end
+		bool getPath( Path& path ) const;
+
+		// does nothing, the next slice sees the maze's new revision and starts the search again
+		void updateNode( PositionVector pos );
+
+		// forgets the search, advance() does nothing until start() is called
+		void reset();
+
+	private:
+		// clears the costs and puts start on the open list, the search is at the maze's revision
+		void restart();
+
+		// returns the estimated cost from 'index' to end
+		int estimateCost( int index ) const;
+
+		const MazeT< WIDTH , HEIGHT >& maze;
+
+		int startNode = 0; // the index of the start node
+		int endNode = 0; // the index of the end node
+		bool isMapping = false;
+
+		bool started = false;
+		bool done = false;
+		unsigned long revision = 0; // the maze's revision the costs are for
+
+		int bestNode; // the expanded node with the lowest estimate to end, or the end node once it is found
+
+		unsigned short* g; // g[ index ] is the cost of the best path found from start
+		unsigned short* parent; // the index of the node before it on that path
+		unsigned char* parentDir; // the direction of the move from the parent
+
+		// a bit for each node, set once it is expanded
+		unsigned int closed[ ( Geometry::NUM_NODES + 31 ) / 32 ];
+
+		NodeHeap openList;
+	};
+
+	// the planner for the maze size the mouse is built for
+	typedef AnytimePlannerT< MAZE_W , MAZE_H > AnytimePlanner;
+}
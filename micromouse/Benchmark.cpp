@@ -0,0 +1,1257 @@
+#include "Benchmark.h"
+
+#ifdef __MK20DX256__ // Teensy Compile
+#else // PC compile
+#include "MouseBot.h"
+#include "CellMaze.h"
+#include "Logger.h"
+#include "Timer.h"
+#include <stdlib.h> //rand, malloc
+#include <string>
+#include <new>
+
+
+
+#ifdef BENCHMARK_ALLOCATIONS
+// every heap allocation in the simulator goes through here so the benchmarks can count them
+// these replace the allocator of the whole program, so they are only built with BENCHMARK_ALLOCATIONS
+static unsigned long allocationCount = 0;
+
+void* operator new( std::size_t size )
+{
+	allocationCount++;
+
+	void* memory = malloc( size != 0 ? size : 1 );
+
+	if ( memory == nullptr )
+	{
+		throw std::bad_alloc();
+	}
+
+	return memory;
+}
+
+void* operator new[]( std::size_t size )
+{
+	return operator new( size );
+}
+
+void operator delete( void* memory ) noexcept
+{
+	free( memory );
+}
+
+void operator delete[]( void* memory ) noexcept
+{
+	free( memory );
+}
+
+void operator delete( void* memory , std::size_t ) noexcept
+{
+	free( memory );
+}
+
+void operator delete[]( void* memory , std::size_t ) noexcept
+{
+	free( memory );
+}
+#endif
+
+
+
+namespace Micromouse
+{
+	const int Benchmark::NUM_MAZES;
+	const int Benchmark::NUM_QUERIES;
+	const int Benchmark::SHORT_QUERY_RANGE;
+	const int Benchmark::NUM_RUNS;
+	const int Benchmark::NUM_MAPPING_MAZES;
+
+
+
+	void Benchmark::runAll()
+	{
+		searchEngines();
+		heuristics();
+		incrementalPlanning();
+		corridorContraction();
+		deadEndPruning();
+		distanceTable();
+		cellMaze();
+		modifiedFloodFill();
+		jumpPointSearch();
+		anytimePlanning();
+		asyncPlanning();
+		explorationPolicies();
+		mappingGap();
+		longQueries();
+		shortQueries();
+		mazeSizes();
+		mapping();
+		repeatedRuns();
+		repeatedWalls();
+		runPlanning();
+	}
+
+
+
+	void Benchmark::searchEngines()
+	{
+		const Maze::SearchEngine engines[] = { Maze::SORTED_LIST , Maze::BINARY_HEAP , Maze::BUCKET_QUEUE , Maze::FLOOD_FILL , Maze::BIDIRECTIONAL , Maze::JUMP_POINT };
+		const int numEngines = sizeof( engines ) / sizeof( engines[ 0 ] );
+
+		log( INFO ) << "Benchmark: search engines on " << NUM_MAZES << " mazes";
+
+		for ( int e = 0; e < numEngines; e++ )
+		{
+			std::string name = getEngineName( engines[ e ] );
+
+			// every query goes through the engine being measured
+			Config config;
+			config.engine = engines[ e ];
+			config.heuristic = Maze::NO_HEURISTIC;
+			config.incrementalPlanning = false;
+			config.corridorContraction = false;
+
+			logResult( ( name + " known mazes" ).c_str() , runKnownMazes( config ) );
+			logResult( ( name + " mapMaze" ).c_str() , runMapping( config ) );
+		}
+	}
+
+
+
+	void Benchmark::heuristics()
+	{
+		const Maze::Heuristic heuristics[] = { Maze::NO_HEURISTIC , Maze::MANHATTAN , Maze::OCTILE , Maze::LOWER_BOUND };
+		const int numHeuristics = sizeof( heuristics ) / sizeof( heuristics[ 0 ] );
+
+		log( INFO ) << "Benchmark: heuristics on " << NUM_MAZES << " mazes";
+
+		for ( int h = 0; h < numHeuristics; h++ )
+		{
+			std::string name = getHeuristicName( heuristics[ h ] );
+
+			Config config;
+			config.heuristic = heuristics[ h ];
+			config.incrementalPlanning = false;
+			config.corridorContraction = false;
+
+			logResult( ( name + " known mazes" ).c_str() , runKnownMazes( config ) );
+			logResult( ( name + " mapMaze" ).c_str() , runMapping( config ) );
+		}
+	}
+
+
+
+	void Benchmark::incrementalPlanning()
+	{
+		log( INFO ) << "Benchmark: incremental planning on " << NUM_MAZES << " mazes";
+
+		Config config;
+
+		config.incrementalPlanning = false;
+		logResult( "full search mapMaze" , runMapping( config ) );
+
+		config.incrementalPlanning = true;
+		logResult( "incremental mapMaze" , runMapping( config ) );
+	}
+
+
+
+	void Benchmark::corridorContraction()
+	{
+		log( INFO ) << "Benchmark: corridor contraction on " << NUM_MAZES << " mazes";
+
+		Config config;
+
+		config.corridorContraction = false;
+		logResult( "node by node known mazes" , runKnownMazes( config ) );
+		logResult( "node by node long queries" , runLongQueries( config ) );
+		logResult( "node by node mapMaze" , runMapping( config ) );
+
+		config.corridorContraction = true;
+		logResult( "corridor graph known mazes" , runKnownMazes( config ) );
+		logResult( "corridor graph long queries" , runLongQueries( config ) );
+		logResult( "corridor graph mapMaze" , runMapping( config ) );
+	}
+
+
+
+	void Benchmark::deadEndPruning()
+	{
+		log( INFO ) << "Benchmark: dead end pruning on " << NUM_MAZES << " mazes";
+
+		for ( int mapped = 0; mapped < 2; mapped++ )
+		{
+			int numExplored = 0;
+			int numDeadEnds = 0;
+
+			for ( int i = 0; i < NUM_MAZES; i++ )
+			{
+				Maze* maze;
+				MouseBot mouse;
+				Maze knownMaze;
+
+				if ( mapped )
+				{
+					srand( getSeed( i ) );
+					mouse.mapMaze();
+					maze = &mouse.getMaze();
+				}
+				else
+				{
+					VirtualMaze virtualMaze( NUM_NODES_W , NUM_NODES_H );
+					generateMaze( virtualMaze , getSeed( i ) );
+					loadVirtualMaze( knownMaze , virtualMaze );
+					maze = &knownMaze;
+				}
+
+				for ( int x = 0; x < NUM_NODES_W; x++ )
+				{
+					for ( int y = 0; y < NUM_NODES_H; y++ )
+					{
+						if ( maze->isExplored( PositionVector( x , y ) ) )
+						{
+							numExplored++;
+							numDeadEnds += maze->isDeadEnd( PositionVector( x , y ) ) ? 1 : 0;
+						}
+					}
+				}
+			}
+
+			const char* mazes = mapped ? "after mapMaze" : "known mazes";
+
+			log( INFO ) << mazes << ": " << 100.0f * numDeadEnds / numExplored << "% of the explored nodes are in dead ends";
+
+			Config config;
+
+			config.deadEndPruning = false;
+			logResult( ( std::string( "unpruned runs, " ) + mazes ).c_str() , runRunQueries( config , mapped != 0 ) );
+
+			config.deadEndPruning = true;
+			logResult( ( std::string( "pruned runs, " ) + mazes ).c_str() , runRunQueries( config , mapped != 0 ) );
+		}
+	}
+
+
+
+	void Benchmark::distanceTable()
+	{
+		log( INFO ) << "Benchmark: distance table on " << NUM_MAZES << " mazes";
+
+		Timer timer;
+		float searchSeconds = 0.0f;
+		float buildSeconds = 0.0f;
+		float lookupSeconds = 0.0f;
+		float landmarkSeconds = 0.0f;
+		int numLandmarkLookups = 0;
+		int numMismatches = 0;
+
+		for ( int i = 0; i < NUM_MAZES; i++ )
+		{
+			VirtualMaze virtualMaze( NUM_NODES_W , NUM_NODES_H );
+			generateMaze( virtualMaze , getSeed( i ) );
+
+			Maze maze;
+			loadVirtualMaze( maze , virtualMaze );
+
+			// the table the Teensy keeps, only START and FINISH are sources
+			DistanceTable landmarks( maze , false );
+
+			timer.start();
+			maze.getDistance( PositionVector::START , PositionVector::FINISH );
+			landmarks.getDistance( PositionVector::START , PositionVector::FINISH );
+			buildSeconds += timer.getDeltaTime();
+
+			Maze::Path path;
+
+			for ( int q = 0; q < NUM_QUERIES; q++ )
+			{
+				PositionVector start = randomOpenPosition( virtualMaze );
+				PositionVector end = randomOpenPosition( virtualMaze );
+
+				timer.start();
+				maze.findPath( start , end , path );
+				float seconds = timer.getDeltaTime();
+				searchSeconds += seconds;
+
+				int moves = 0;
+
+				while ( !path.empty() )
+				{
+					moves += path.popStep().mag();
+				}
+
+				timer.start();
+				int distance = maze.getDistance( start , end );
+				lookupSeconds += timer.getDeltaTime();
+
+				// the Teensy's getDistance only looks up the queries from or to START and FINISH,
+				// the others cost it the findPath above
+				int landmarkDistance = moves;
+
+				if ( landmarks.hasRows( start , end ) )
+				{
+					timer.start();
+					landmarkDistance = landmarks.getDistance( start , end );
+					landmarkSeconds += timer.getDeltaTime();
+					numLandmarkLookups++;
+				}
+				else
+				{
+					landmarkSeconds += seconds;
+				}
+
+				numMismatches += distance != moves || landmarkDistance != moves ? 1 : 0;
+			}
+		}
+
+		const int numQueries = NUM_MAZES * NUM_QUERIES;
+
+		log( INFO ) << "known mazes: findPath " << searchSeconds * 1000000.0f / numQueries << " us/query, "
+			<< "every pair " << lookupSeconds * 1000000.0f / numQueries << " us/query, "
+			<< "START and FINISH only " << landmarkSeconds * 1000000.0f / numQueries << " us/query with "
+			<< numLandmarkLookups << " lookups, "
+			<< buildSeconds * 1000.0f / NUM_MAZES << " ms to build both per maze, "
+			<< numMismatches << " distances differ from findPath";
+
+		Config config;
+
+		config.distanceTable = false;
+		logResult( "mapMaze without a distance table" , runMapping( config ) );
+
+		config.distanceTable = true;
+		logResult( "mapMaze keeping a distance table" , runMapping( config ) );
+	}
+
+
+
+	void Benchmark::cellMaze()
+	{
+		log( INFO ) << "Benchmark: cell maze on " << NUM_MAZES << " mazes";
+
+		// the node graph with the default settings and with the same flood fill, and the cell maze
+		const int NUM_SOLVERS = 3;
+		const char* names[ NUM_SOLVERS ] = { "Maze default" , "Maze FLOOD_FILL" , "CellMaze" };
+		float seconds[ NUM_SOLVERS ] = {};
+		int numMismatches = 0;
+
+		Timer timer;
+
+		for ( int i = 0; i < NUM_MAZES; i++ )
+		{
+			VirtualMaze virtualMaze( NUM_NODES_W , NUM_NODES_H );
+			generateMaze( virtualMaze , getSeed( i ) );
+
+			Maze maze;
+			Maze floodMaze;
+			loadVirtualMaze( maze , virtualMaze );
+			loadVirtualMaze( floodMaze , virtualMaze );
+
+			Config config;
+			config.engine = Maze::FLOOD_FILL;
+			config.corridorContraction = false;
+			configure( floodMaze , config );
+
+			CellMaze cellMaze;
+			cellMaze.fromMaze( maze );
+
+			Maze::Path path;
+
+			for ( int q = 0; q < NUM_QUERIES; q++ )
+			{
+				PositionVector start( 2 * ( rand() % MAZE_W ) , 2 * ( rand() % MAZE_H ) );
+				PositionVector end( 2 * ( rand() % MAZE_W ) , 2 * ( rand() % MAZE_H ) );
+
+				int moves[ NUM_SOLVERS ] = {};
+
+				for ( int s = 0; s < NUM_SOLVERS; s++ )
+				{
+					timer.start();
+
+					if ( s == 2 )
+					{
+						cellMaze.findPath( start , end , path );
+					}
+					else
+					{
+						( s == 0 ? maze : floodMaze ).findPath( start , end , path );
+					}
+
+					seconds[ s ] += timer.getDeltaTime();
+
+					while ( !path.empty() )
+					{
+						moves[ s ] += path.popStep().mag();
+					}
+				}
+
+				numMismatches += moves[ 0 ] != moves[ 2 ] || moves[ 1 ] != moves[ 2 ] ? 1 : 0;
+			}
+		}
+
+		for ( int s = 0; s < NUM_SOLVERS; s++ )
+		{
+			log( INFO ) << names[ s ] << " known mazes: " << seconds[ s ] * 1000000.0f / ( NUM_MAZES * NUM_QUERIES ) << " us/query";
+		}
+
+		log( INFO ) << numMismatches << " CellMaze paths differ in length from Maze, "
+			<< sizeof( Maze ) << " bytes per Maze, " << sizeof( CellMaze ) << " bytes per CellMaze";
+	}
+
+
+
+	void Benchmark::modifiedFloodFill()
+	{
+		log( INFO ) << "Benchmark: modified flood fill on " << NUM_MAZES << " mazes";
+
+		Config config;
+
+		config.floodFillMapping = false;
+		Result searches = runMapping( config );
+
+		config.floodFillMapping = true;
+		Result floodFill = runMapping( config );
+
+		logResult( "mapMaze" , searches );
+		log( INFO ) << "mapMaze: " << static_cast< float >( searches.moves ) / NUM_MAZES << " moves per maze";
+
+		logResult( "mapMazeFloodFill" , floodFill );
+		log( INFO ) << "mapMazeFloodFill: " << static_cast< float >( floodFill.moves ) / NUM_MAZES << " moves per maze";
+	}
+
+
+
+	void Benchmark::jumpPointSearch()
+	{
+		const Maze::SearchEngine engines[] = { Maze::BINARY_HEAP , Maze::JUMP_POINT };
+
+		log( INFO ) << "Benchmark: jump point search on " << NUM_MAZES << " mazes";
+
+		for ( int e = 0; e < 2; e++ )
+		{
+			std::string name = getEngineName( engines[ e ] );
+
+			// every query goes through the engine being measured
+			Config config;
+			config.engine = engines[ e ];
+			config.incrementalPlanning = false;
+			config.corridorContraction = false;
+
+			config.openWallPercent = 0;
+			logResult( ( name + " tight mazes" ).c_str() , runKnownMazes( config ) );
+
+			config.openWallPercent = 50;
+			logResult( ( name + " open mazes" ).c_str() , runKnownMazes( config ) );
+
+			logResult( ( name + " mapMaze" ).c_str() , runMapping( config ) );
+		}
+	}
+
+
+
+	void Benchmark::anytimePlanning()
+	{
+		const int sliceExpansions[] = { 16 , 64 , 256 };
+
+		log( INFO ) << "Benchmark: anytime planning on " << NUM_MAZES << " mazes";
+
+		// the anytime search is A* node by node, like findPath without the CorridorGraph
+		Config config;
+		config.corridorContraction = false;
+
+		Result searches = runKnownMazes( config );
+		logResult( "findPath" , searches );
+		log( INFO ) << "findPath: worst query " << searches.maxSeconds * 1000000.0f << " us";
+
+		for ( int s = 0; s < 3; s++ )
+		{
+			std::string name = "anytime " + std::to_string( sliceExpansions[ s ] ) + " expansions";
+
+			Result anytime = runAnytimeQueries( config , sliceExpansions[ s ] , 0 );
+			logResult( name.c_str() , anytime );
+			log( INFO ) << name << ": worst slice " << anytime.maxSeconds * 1000000.0f << " us, "
+				<< static_cast< float >( anytime.slices ) / ( NUM_MAZES * NUM_QUERIES ) << " slices per query";
+		}
+
+		// a time budget stops the slices that would run long, down to the time of one expansion
+		Result budget = runAnytimeQueries( config , 256 , 10 );
+		logResult( "anytime 10 us" , budget );
+		log( INFO ) << "anytime 10 us: worst slice " << budget.maxSeconds * 1000000.0f << " us, "
+			<< static_cast< float >( budget.slices ) / ( NUM_MAZES * NUM_QUERIES ) << " slices per query";
+	}
+
+
+
+	void Benchmark::asyncPlanning()
+	{
+		// first the moves take no time, so the mouse never starts the worker, then a ten thousandth of the
+		// predicted time, about 0.25 ms a move, which leaves the worker time to plan for every guess
+		const float timeScales[] = { 0.0f , 0.0001f };
+
+		log( INFO ) << "Benchmark: async planning on " << NUM_MAZES << " mazes";
+
+		for ( int t = 0; t < 2; t++ )
+		{
+			std::string name = "time scale " + std::to_string( timeScales[ t ] );
+
+			Config config;
+			config.motionTimeScale = timeScales[ t ];
+
+			config.asyncPlanning = false;
+			Result sync = runMapping( config );
+
+			config.asyncPlanning = true;
+			Result async = runMapping( config );
+
+			logResult( ( name + " mapMaze" ).c_str() , sync );
+			log( INFO ) << name << " mapMaze: " << static_cast< float >( sync.moves ) / NUM_MAZES << " moves, "
+				<< sync.seconds * 1000.0f / NUM_MAZES << " ms per maze";
+
+			logResult( ( name + " async mapMaze" ).c_str() , async );
+			log( INFO ) << name << " async mapMaze: " << static_cast< float >( async.moves ) / NUM_MAZES << " moves, "
+				<< async.seconds * 1000.0f / NUM_MAZES << " ms per maze, "
+				<< async.stalePlans << " of " << async.plans << " plans stale";
+		}
+	}
+
+
+
+	void Benchmark::explorationPolicies()
+	{
+		log( INFO ) << "Benchmark: exploration policies on " << NUM_MAPPING_MAZES << " mazes";
+
+		Config config;
+
+		FrontierPolicy frontier;
+		FrontierPolicy scored;
+		scored.setRevealWeight( 0.1f );
+		scored.setBlockedWeight( 1.0f );
+
+		const char* names[] = { "NearestPassagePolicy" , "FrontierPolicy" , "FrontierPolicy with scores" };
+		ExplorationPolicy* policies[] = { nullptr , &frontier , &scored };
+
+		for ( int p = 0; p < 3; p++ )
+		{
+			config.explorationPolicy = policies[ p ];
+
+			Result result = runMapping( config , NUM_MAPPING_MAZES );
+			logResult( names[ p ] , result );
+			log( INFO ) << names[ p ] << ": " << static_cast< float >( result.moves ) / NUM_MAPPING_MAZES << " moves per maze";
+		}
+	}
+
+
+
+	void Benchmark::mappingGap()
+	{
+		const float gaps[] = { 0.0f , 0.05f , 0.1f , 0.2f };
+
+		log( INFO ) << "Benchmark: mapping gap on " << NUM_MAPPING_MAZES << " mazes";
+
+		Config config;
+		Result complete;
+
+		for ( int g = 0; g < 4; g++ )
+		{
+			config.mappingGap = gaps[ g ];
+
+			Result result = runMapping( config , NUM_MAPPING_MAZES );
+
+			// the complete mapping finds the shortest path of every maze
+			if ( g == 0 )
+			{
+				complete = result;
+			}
+
+			std::string name = "gap " + std::to_string( gaps[ g ] );
+
+			logResult( name.c_str() , result );
+			log( INFO ) << name << ": " << static_cast< float >( result.moves ) / NUM_MAPPING_MAZES << " moves per maze, "
+				<< 100.0f * ( static_cast< float >( complete.moves ) - result.moves ) / complete.moves << "% saved, "
+				<< static_cast< float >( result.runMoves ) / NUM_MAPPING_MAZES << " moves from START to FINISH, "
+				<< 100.0f * ( static_cast< float >( result.runMoves ) - complete.runMoves ) / complete.runMoves << "% longer";
+		}
+	}
+
+
+
+	void Benchmark::longQueries()
+	{
+		log( INFO ) << "Benchmark: long queries on " << NUM_MAZES << " mazes";
+
+		Config config;
+		config.incrementalPlanning = false;
+		config.corridorContraction = false;
+
+		config.engine = Maze::BINARY_HEAP;
+		logResult( "BINARY_HEAP MANHATTAN long queries" , runLongQueries( config ) );
+
+		config.heuristic = Maze::NO_HEURISTIC;
+		logResult( "BINARY_HEAP long queries" , runLongQueries( config ) );
+
+		config.engine = Maze::FLOOD_FILL;
+		logResult( "FLOOD_FILL long queries" , runLongQueries( config ) );
+
+		config.engine = Maze::BIDIRECTIONAL;
+		logResult( "BIDIRECTIONAL long queries" , runLongQueries( config ) );
+	}
+
+
+
+	void Benchmark::shortQueries()
+	{
+		log( INFO ) << "Benchmark: short queries on " << NUM_MAZES << " mazes";
+
+		Config config;
+		config.incrementalPlanning = false;
+
+		logResult( "short queries" , runShortQueries( config ) );
+	}
+
+
+
+	void Benchmark::mazeSizes()
+	{
+		log( INFO ) << "Benchmark: maze sizes on " << NUM_MAZES << " mazes";
+
+		Config config;
+
+		logResult( "16x16 known mazes" , runKnownMazes< 16 , 16 >( config ) );
+		logResult( "32x32 known mazes" , runKnownMazes< 32 , 32 >( config ) );
+	}
+
+
+
+	void Benchmark::mapping()
+	{
+		log( INFO ) << "Benchmark: mapping on " << NUM_MAZES << " mazes";
+
+		// the simulated moves are free, so the time is the planning time
+		Result result = runMapping( Config() );
+
+		log( INFO ) << "mapMaze: " << static_cast< float >( result.moves ) / NUM_MAZES << " moves, "
+			<< result.seconds * 1000.0f / NUM_MAZES << " ms planning per maze";
+	}
+
+
+
+	void Benchmark::repeatedRuns()
+	{
+		log( INFO ) << "Benchmark: " << NUM_RUNS << " runs after mapping on " << NUM_MAZES << " mazes";
+
+		Result result;
+		Timer timer;
+
+		for ( int i = 0; i < NUM_MAZES; i++ )
+		{
+			srand( getSeed( i ) );
+
+			MouseBot mouse;
+			mouse.mapMaze();
+			mouse.getMaze().resetSearchStats();
+
+			timer.start();
+
+			for ( int r = 0; r < NUM_RUNS; r++ )
+			{
+				mouse.runMaze();
+			}
+
+			result.seconds += timer.getDeltaTime();
+
+			addSearchStats( result , mouse.getMaze() );
+		}
+
+		logResult( "runMaze" , result );
+	}
+
+
+
+	void Benchmark::repeatedWalls()
+	{
+		log( INFO ) << "Benchmark: walls seen again on " << NUM_MAZES << " mazes";
+
+		int failures = 0;
+
+		for ( int i = 0; i < NUM_MAZES; i++ )
+		{
+			VirtualMaze virtualMaze( NUM_NODES_W , NUM_NODES_H );
+			generateMaze( virtualMaze , getSeed( i ) );
+
+			Maze maze;
+			loadVirtualMaze( maze , virtualMaze );
+
+			Maze::Path path;
+			maze.findPath( PositionVector::START , PositionVector::FINISH , path );
+
+			unsigned long revision = maze.getRevision();
+			unsigned long cacheHits = maze.getSearchStats().cacheHits;
+
+			// removes every wall and explores every open node again
+			loadVirtualMaze( maze , virtualMaze );
+			maze.findPath( PositionVector::START , PositionVector::FINISH , path );
+
+			if ( maze.getRevision() != revision || maze.getSearchStats().cacheHits != cacheHits + 1 )
+			{
+				log( ERROR ) << "maze " << i << ": seeing the walls again changed the revision or missed the path cache";
+				failures++;
+			}
+		}
+
+		log( INFO ) << "repeatedWalls: " << NUM_MAZES - failures << " of " << NUM_MAZES << " mazes kept the cached path";
+	}
+
+
+
+	void Benchmark::runPlanning()
+	{
+		log( INFO ) << "Benchmark: run planning on " << NUM_MAZES << " mazes";
+
+		float fewestNodesTime = 0.0f;
+		float fastestTime = 0.0f;
+		float compiledTime = 0.0f;
+		float planningSeconds = 0.0f;
+		Timer timer;
+
+		for ( int i = 0; i < NUM_MAZES; i++ )
+		{
+			VirtualMaze virtualMaze( NUM_NODES_W , NUM_NODES_H );
+			generateMaze( virtualMaze , getSeed( i ) );
+
+			Maze maze;
+			loadVirtualMaze( maze , virtualMaze );
+
+			Maze::Path path;
+
+			maze.findPath( PositionVector::START , PositionVector::FINISH , path );
+			fewestNodesTime += predictRunTime( maze.getMotionModel() , path , N );
+
+			timer.start();
+			maze.findRunPath( PositionVector::START , N , PositionVector::FINISH , path );
+			planningSeconds += timer.getDeltaTime();
+
+			fastestTime += predictRunTime( maze.getMotionModel() , path , N );
+			compiledTime += MotionCompiler( path , N , maze.getMotionModel() ).getTime();
+		}
+
+		log( INFO ) << "fewest nodes: " << fewestNodesTime / NUM_MAZES << "s predicted per run";
+		log( INFO ) << "lowest time: " << fastestTime / NUM_MAZES << "s predicted per run, "
+			<< planningSeconds * 1000.0f / NUM_MAZES << "ms to plan";
+		log( INFO ) << "lowest time compiled: " << compiledTime / NUM_MAZES << "s predicted per run without a stop after every step";
+	}
+
+
+
+	float Benchmark::predictRunTime( const MotionModel & model , Maze::Path path , direction facing )
+	{
+		float seconds = 0.0f;
+
+		while ( !path.empty() )
+		{
+			DirectionVector step = path.popStep();
+
+			seconds += model.getTurnTime( step.dir() - facing ) + model.getStraightTime( step.mag() , step.dir() % 2 != 0 );
+			facing = step.dir();
+		}
+
+		return seconds;
+	}
+
+
+
+	void Benchmark::configure( MazeBase & maze , const Config & config )
+	{
+		maze.setSearchEngine( config.engine );
+		maze.setHeuristic( config.heuristic );
+		maze.setIncrementalPlanning( config.incrementalPlanning );
+		maze.setCorridorContraction( config.corridorContraction );
+		maze.setDeadEndPruning( config.deadEndPruning );
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	Benchmark::Result Benchmark::runKnownMazes( const Config& config )
+	{
+		typedef MazeGeometry< WIDTH , HEIGHT > Geometry;
+
+		Result result;
+		Timer timer;
+
+		for ( int i = 0; i < NUM_MAZES; i++ )
+		{
+			VirtualMaze virtualMaze( Geometry::NUM_NODES_W , Geometry::NUM_NODES_H );
+			generateMaze( virtualMaze , getSeed( i ) );
+			openWalls( virtualMaze , config.openWallPercent );
+
+			MazeT< WIDTH , HEIGHT > maze;
+			loadVirtualMaze( maze , virtualMaze );
+			configure( maze , config );
+
+			PositionVector finish = MazeT< WIDTH , HEIGHT >::getFinish();
+			typename MazeT< WIDTH , HEIGHT >::Path path;
+
+			// the queries only depend on the seed so they are the same for every configuration
+			for ( int q = 0; q < NUM_QUERIES; q++ )
+			{
+				// the first two queries are START to FINISH and back
+				PositionVector start = q == 0 ? PositionVector::START : q == 1 ? finish : randomOpenPosition< WIDTH , HEIGHT >( virtualMaze );
+				PositionVector end = q == 0 ? finish : q == 1 ? PositionVector::START : randomOpenPosition< WIDTH , HEIGHT >( virtualMaze );
+
+				unsigned long allocations = getAllocationCount();
+				timer.start();
+				maze.findPath( start , end , path );
+				float seconds = timer.getDeltaTime();
+				result.allocations += getAllocationCount() - allocations;
+
+				result.seconds += seconds;
+
+				if ( seconds > result.maxSeconds )
+				{
+					result.maxSeconds = seconds;
+				}
+			}
+
+			addSearchStats( result , maze );
+		}
+
+		return result;
+	}
+
+
+
+	Benchmark::Result Benchmark::runAnytimeQueries( const Config& config , int sliceExpansions , unsigned long sliceMicros )
+	{
+		Result result;
+		Timer timer;
+
+		for ( int i = 0; i < NUM_MAZES; i++ )
+		{
+			VirtualMaze virtualMaze( NUM_NODES_W , NUM_NODES_H );
+			generateMaze( virtualMaze , getSeed( i ) );
+			openWalls( virtualMaze , config.openWallPercent );
+
+			Maze maze;
+			loadVirtualMaze( maze , virtualMaze );
+			configure( maze , config );
+			maze.setAnytimeSlice( sliceExpansions , sliceMicros );
+
+			// the planner is allocated by the first search
+			maze.startAnytimeSearch( PositionVector::START , PositionVector::START );
+
+			Maze::Path path;
+
+			// the same queries as runKnownMazes
+			for ( int q = 0; q < NUM_QUERIES; q++ )
+			{
+				PositionVector start = q == 0 ? PositionVector::START : q == 1 ? PositionVector::FINISH : randomOpenPosition( virtualMaze );
+				PositionVector end = q == 0 ? PositionVector::FINISH : q == 1 ? PositionVector::START : randomOpenPosition( virtualMaze );
+
+				unsigned long allocations = getAllocationCount();
+				timer.start();
+				maze.startAnytimeSearch( start , end );
+				result.seconds += timer.getDeltaTime();
+				result.allocations += getAllocationCount() - allocations;
+
+				bool done = false;
+
+				while ( !done )
+				{
+					allocations = getAllocationCount();
+					timer.start();
+					done = maze.advanceAnytimeSearch();
+					maze.getAnytimePath( path );
+					float seconds = timer.getDeltaTime();
+					result.allocations += getAllocationCount() - allocations;
+
+					result.seconds += seconds;
+
+					if ( seconds > result.maxSeconds )
+					{
+						result.maxSeconds = seconds;
+					}
+				}
+			}
+
+			addSearchStats( result , maze );
+		}
+
+		return result;
+	}
+
+
+
+	Benchmark::Result Benchmark::runMapping( const Config& config , int numMazes )
+	{
+		Result result;
+		Timer timer;
+
+		// the mouse creates the same maze for the same seed
+		for ( int i = 0; i < numMazes; i++ )
+		{
+			srand( getSeed( i ) );
+
+			MouseBot mouse;
+			configure( mouse.getMaze() , config );
+
+			if ( config.distanceTable )
+			{
+				// from here on mapMaze marks the table for repair as it explores
+				mouse.getMaze().getDistance( PositionVector::START , PositionVector::FINISH );
+			}
+
+			if ( config.floodFillMapping )
+			{
+				// the flood fill is allocated the first time a goal is set, mapMazeFloodFill sets it again
+				mouse.getMaze().setFloodGoal( PositionVector::FINISH );
+			}
+
+			// the worker is started before the timer
+			mouse.setAsyncPlanning( config.asyncPlanning );
+			mouse.setMotionTimeScale( config.motionTimeScale );
+			mouse.setExplorationPolicy( config.explorationPolicy );
+			mouse.setMappingGap( config.mappingGap );
+
+			unsigned long allocations = getAllocationCount();
+			timer.start();
+			result.moves += config.floodFillMapping ? mouse.mapMazeFloodFill() : mouse.mapMaze();
+			result.seconds += timer.getDeltaTime();
+			result.allocations += getAllocationCount() - allocations;
+
+			addSearchStats( result , mouse.getMaze() );
+
+			if ( mouse.getPlannerThread() != nullptr )
+			{
+				addSearchStats( result , mouse.getPlannerThread()->getSearchStats() );
+				result.plans += mouse.getPlannerThread()->getPlans();
+				result.stalePlans += mouse.getPlannerThread()->getStalePlans();
+			}
+
+			// after the counters, so this query is not counted
+			Maze::Path path;
+			mouse.getMaze().findPath( PositionVector::START , PositionVector::FINISH , path );
+
+			for ( int s = 0; s < path.size(); s++ )
+			{
+				result.runMoves += path.getStep( s ).mag();
+			}
+		}
+
+		return result;
+	}
+
+
+
+	Benchmark::Result Benchmark::runLongQueries( const Config & config )
+	{
+		// the corners in the order they are queried, each query goes to the opposite corner
+		const PositionVector corners[] = {
+			PositionVector( 0 , 0 ) , PositionVector( NUM_NODES_W - 1 , NUM_NODES_H - 1 ) ,
+			PositionVector( NUM_NODES_W - 1 , 0 ) , PositionVector( 0 , NUM_NODES_H - 1 ) };
+		const int numCorners = sizeof( corners ) / sizeof( corners[ 0 ] );
+
+		Result result;
+		Timer timer;
+
+		for ( int i = 0; i < NUM_MAZES; i++ )
+		{
+			VirtualMaze virtualMaze( NUM_NODES_W , NUM_NODES_H );
+			generateMaze( virtualMaze , getSeed( i ) );
+
+			Maze maze;
+			loadVirtualMaze( maze , virtualMaze );
+			configure( maze , config );
+
+			Maze::Path path;
+
+			for ( int q = 0; q < numCorners + 2; q++ )
+			{
+				PositionVector start = q < numCorners ? corners[ q ] : q == numCorners ? PositionVector::START : PositionVector::FINISH;
+				PositionVector end = q < numCorners ? corners[ q ^ 1 ] : q == numCorners ? PositionVector::FINISH : PositionVector::START;
+
+				unsigned long allocations = getAllocationCount();
+				timer.start();
+				maze.findPath( start , end , path );
+				result.seconds += timer.getDeltaTime();
+				result.allocations += getAllocationCount() - allocations;
+			}
+
+			addSearchStats( result , maze );
+		}
+
+		return result;
+	}
+
+
+
+	Benchmark::Result Benchmark::runRunQueries( const Config & config , bool mapped )
+	{
+		Result result;
+
+		for ( int i = 0; i < NUM_MAZES; i++ )
+		{
+			if ( mapped )
+			{
+				srand( getSeed( i ) );
+
+				MouseBot mouse;
+				mouse.mapMaze();
+
+				configure( mouse.getMaze() , config );
+				runRunQueries( mouse.getMaze() , result );
+			}
+			else
+			{
+				VirtualMaze virtualMaze( NUM_NODES_W , NUM_NODES_H );
+				generateMaze( virtualMaze , getSeed( i ) );
+
+				Maze maze;
+				loadVirtualMaze( maze , virtualMaze );
+				configure( maze , config );
+				runRunQueries( maze , result );
+			}
+		}
+
+		return result;
+	}
+
+
+
+	void Benchmark::runRunQueries( Maze & maze , Result & result )
+	{
+		Timer timer;
+		Maze::Path path;
+
+		maze.resetSearchStats();
+
+		unsigned long allocations = getAllocationCount();
+		timer.start();
+
+		maze.findRunPath( PositionVector::START , N , PositionVector::FINISH , path );
+		maze.findRunPath( PositionVector::FINISH , S , PositionVector::START , path );
+		maze.findPath( PositionVector::START , PositionVector::FINISH , path );
+		maze.findPath( PositionVector::FINISH , PositionVector::START , path );
+
+		result.seconds += timer.getDeltaTime();
+		result.allocations += getAllocationCount() - allocations;
+
+		addSearchStats( result , maze );
+	}
+
+
+
+	Benchmark::Result Benchmark::runShortQueries( const Config & config )
+	{
+		Result result;
+		Timer timer;
+
+		for ( int i = 0; i < NUM_MAZES; i++ )
+		{
+			VirtualMaze virtualMaze( NUM_NODES_W , NUM_NODES_H );
+			generateMaze( virtualMaze , getSeed( i ) );
+
+			Maze maze;
+			loadVirtualMaze( maze , virtualMaze );
+			configure( maze , config );
+
+			Maze::Path path;
+
+			for ( int q = 0; q < NUM_QUERIES; q++ )
+			{
+				PositionVector start = randomOpenPosition( virtualMaze );
+				PositionVector end = randomOpenPosition( virtualMaze , start , SHORT_QUERY_RANGE );
+
+				unsigned long allocations = getAllocationCount();
+				timer.start();
+				maze.findPath( start , end , path );
+				result.seconds += timer.getDeltaTime();
+				result.allocations += getAllocationCount() - allocations;
+			}
+
+			addSearchStats( result , maze );
+		}
+
+		return result;
+	}
+
+
+
+	void Benchmark::addSearchStats( Result & result , const MazeBase & maze )
+	{
+		addSearchStats( result , maze.getSearchStats() );
+	}
+
+
+
+	void Benchmark::addSearchStats( Result & result , const MazeBase::SearchStats & stats )
+	{
+		result.searches += stats.searches;
+		result.nodesExpanded += stats.nodesExpanded;
+		result.cacheHits += stats.cacheHits;
+		result.slices += stats.slices;
+
+		if ( stats.maxNodesExpanded > result.maxNodesExpanded )
+		{
+			result.maxNodesExpanded = stats.maxNodesExpanded;
+		}
+	}
+
+
+
+	void Benchmark::logResult( const char * name , const Result & result )
+	{
+		log( INFO ) << name << ": "
+			<< result.searches << " searches, "
+			<< result.nodesExpanded << " expansions ("
+			<< result.nodesExpanded / result.searches << " avg, "
+			<< result.maxNodesExpanded << " max), "
+			<< result.seconds * 1000.0f << " ms, "
+			<< result.seconds * 1000000.0f / result.searches << " us/search, "
+			<< result.nodesExpanded / result.seconds << " expansions/s, "
+#ifdef BENCHMARK_ALLOCATIONS
+			<< result.allocations << " allocations, "
+#endif
+			<< result.cacheHits << " cache hits";
+	}
+
+
+
+	unsigned long Benchmark::getAllocationCount()
+	{
+#ifdef BENCHMARK_ALLOCATIONS
+		return allocationCount;
+#else
+		return 0;
+#endif
+	}
+
+
+
+	unsigned int Benchmark::getSeed( int i )
+	{
+		return 1000 + i;
+	}
+
+
+
+	void Benchmark::generateMaze( VirtualMaze & virtualMaze , unsigned int seed )
+	{
+		srand( seed );
+		virtualMaze.generateRandomMaze();
+	}
+
+
+
+	void Benchmark::openWalls( VirtualMaze & virtualMaze , int percent )
+	{
+		if ( percent == 0 )
+		{
+			return;
+		}
+
+		// the walls are the edges between two cells, where exactly one of x and y is odd
+		for ( int x = 1; x < virtualMaze.getWidth() - 1; x++ )
+		{
+			for ( int y = 1; y < virtualMaze.getHeight() - 1; y++ )
+			{
+				if ( ( x + y ) % 2 == 1 && rand() % 100 < percent )
+				{
+					virtualMaze.setOpen( true , x , y );
+				}
+			}
+		}
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	void Benchmark::loadVirtualMaze( MazeT< WIDTH , HEIGHT > & maze , const VirtualMaze & virtualMaze )
+	{
+		typedef MazeGeometry< WIDTH , HEIGHT > Geometry;
+
+		for ( int x = 0; x < Geometry::NUM_NODES_W; x++ )
+		{
+			for ( int y = 0; y < Geometry::NUM_NODES_H; y++ )
+			{
+				if ( !Geometry::isValidPosition( x , y ) )
+				{
+					continue;
+				}
+
+				if ( virtualMaze.isOpen( x , y ) )
+				{
+					maze.setExplored( PositionVector( x , y ) );
+				}
+				else
+				{
+					maze.removeNode( PositionVector( x , y ) );
+				}
+			}
+		}
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	PositionVector Benchmark::randomOpenPosition( const VirtualMaze & virtualMaze )
+	{
+		typedef MazeGeometry< WIDTH , HEIGHT > Geometry;
+
+		int x , y;
+
+		do
+		{
+			x = rand() % Geometry::NUM_NODES_W;
+			y = rand() % Geometry::NUM_NODES_H;
+		} while ( !Geometry::isValidPosition( x , y ) || !virtualMaze.isOpen( x , y ) );
+
+		return PositionVector( x , y );
+	}
+
+
+
+	PositionVector Benchmark::randomOpenPosition( const VirtualMaze & virtualMaze , PositionVector pos , int range )
+	{
+		int x , y;
+
+		do
+		{
+			x = pos.x() + rand() % ( 2 * range + 1 ) - range;
+			y = pos.y() + rand() % ( 2 * range + 1 ) - range;
+		} while ( !isValidPosition( x , y ) || !virtualMaze.isOpen( x , y ) );
+
+		return PositionVector( x , y );
+	}
+
+
+
+	const char * Benchmark::getEngineName( Maze::SearchEngine engine )
+	{
+		switch ( engine )
+		{
+		case Maze::SORTED_LIST:		return "SORTED_LIST";
+		case Maze::BINARY_HEAP:		return "BINARY_HEAP";
+		case Maze::BUCKET_QUEUE:	return "BUCKET_QUEUE";
+		case Maze::FLOOD_FILL:		return "FLOOD_FILL";
+		case Maze::BIDIRECTIONAL:	return "BIDIRECTIONAL";
+		case Maze::JUMP_POINT:		return "JUMP_POINT";
+		default:					return "UNKNOWN";
+		}
+	}
+
+
+
+	const char * Benchmark::getHeuristicName( Maze::Heuristic heuristic )
+	{
+		switch ( heuristic )
+		{
+		case Maze::NO_HEURISTIC:	return "NO_HEURISTIC";
+		case Maze::MANHATTAN:		return "MANHATTAN";
+		case Maze::OCTILE:			return "OCTILE";
+		case Maze::LOWER_BOUND:		return "LOWER_BOUND";
+		default:					return "UNKNOWN";
+		}
+	}
+}
+#endif
@@ -0,0 +1,212 @@
+#pragma once
+#include "Maze.h"
+#include "ExplorationPolicy.h"
+
+#ifdef __MK20DX256__ // Teensy Compile
+#else
+	#include "VirtualMaze.h"
+#endif
+
+
+
+namespace Micromouse
+{
+#ifdef __MK20DX256__ // Teensy Compile
+#else // PC compile
+	// Host side benchmarks for the pathfinding code.
+	// Every benchmark runs on the same seeded virtual mazes so the results
+	// can be compared between search engines and between builds.
+	// Call from Controller::debug(), the results are logged at INFO.
+	// The heap allocations are only counted when the simulator is built with BENCHMARK_ALLOCATIONS defined.
+	class Benchmark
+	{
+	public:
+		// runs every benchmark
+		static void runAll();
+
+		// compares the latency and expansions per second of the search engines
+		// in Maze::findPath on queries over fully known mazes and on complete mapMaze runs
+		static void searchEngines();
+
+		// compares the nodes expanded per query with each heuristic in Maze::findPath
+		static void heuristics();
+
+		// compares complete mapMaze runs with and without the IncrementalPlanner
+		// answering the START to FINISH queries
+		static void incrementalPlanning();
+
+		// compares searching node by node with searching the CorridorGraph on queries over explored nodes
+		static void corridorContraction();
+
+		// measures the share of the explored nodes in dead ends and compares the run queries,
+		// START to FINISH and back with findRunPath and findPath, with and without dead end pruning
+		static void deadEndPruning();
+
+		// compares answering distance queries between explored nodes with findPath, with the DistanceTable
+		// the host keeps and with the one the Teensy keeps, and the cost of keeping it up to date in mapMaze
+		static void distanceTable();
+
+		// compares Maze::findPath with the flood fill of a CellMaze on queries between cells of
+		// mazes where every wall is known, and the memory each needs
+		static void cellMaze();
+
+		// compares complete mapMaze runs with complete mapMazeFloodFill runs, where every step only
+		// repairs the flood distances around the walls it found
+		static void modifiedFloodFill();
+
+		// compares JUMP_POINT with BINARY_HEAP on the generated mazes, on open mazes with half of their
+		// inner walls knocked down and on complete mapMaze runs, whose queries count unexplored nodes as open
+		static void jumpPointSearch();
+
+		// compares the worst query latency of findPath with the worst slice latency of the anytime search,
+		// on the same queries over fully known mazes, for a few slice limits
+		static void anytimePlanning();
+
+		// compares the wall clock time of complete mapMaze runs planning after every mapping path and
+		// planning on a PlannerThread while the mouse drives it, with the moves sleeping for a share of
+		// the time the motion model predicts, and counts the plans that were stale
+		static void asyncPlanning();
+
+		// compares the moves of complete mapMaze runs with the default NearestPassagePolicy and with the
+		// FrontierPolicy, also with its scores for the nodes seen and the blocked passages turned on
+		static void explorationPolicies();
+
+		// compares complete mapMaze runs with mapMaze runs stopped early by MouseBot::setMappingGap,
+		// the moves saved while mapping against how much longer the known path from START to FINISH is
+		static void mappingGap();
+
+		// compares BIDIRECTIONAL with the one way engines on queries across the whole maze,
+		// like the START to FINISH queries of mapMaze
+		static void longQueries();
+
+		// measures queries between nearby nodes, where setting up a search costs
+		// about as much as the few nodes it expands
+		static void shortQueries();
+
+		// compares the same known maze queries on the 16x16 MazeT and on the half size 32x32 MazeT
+		static void mazeSizes();
+
+		// measures the moves and the planning time of complete mapMaze runs with the default settings
+		static void mapping();
+
+		// runs the maze several times after mapping it, the repeated run and return queries
+		// are answered by the path cache
+		static void repeatedRuns();
+
+		// checks that seeing every wall and open node of a known maze again, as lookAround does on every
+		// step, keeps the maze's revision, so a query asked before is still answered by the path cache
+		static void repeatedWalls();
+
+		// compares the predicted run time from START to FINISH of the path with the fewest nodes
+		// from Maze::findPath and the path with the lowest predicted time from Maze::findRunPath,
+		// also when it is compiled by MotionCompiler
+		static void runPlanning();
+
+	private:
+		Benchmark() {};//dont instantiate me
+
+		// the totals from running one benchmark configuration over every maze
+		struct Result
+		{
+			unsigned long searches = 0;
+			unsigned long nodesExpanded = 0;
+			unsigned long maxNodesExpanded = 0;
+			unsigned long allocations = 0; // heap allocations made by the timed code
+			unsigned long moves = 0; // moves made by the mouse, only counted by runMapping
+			unsigned long cacheHits = 0; // queries answered by the path cache
+			unsigned long slices = 0; // slices of the anytime search, only counted by runAnytimeQueries
+			unsigned long plans = 0; // plans taken from the PlannerThread, only counted by runMapping
+			unsigned long stalePlans = 0; // the plans that were stale and planned again
+			unsigned long runMoves = 0; // moves of the shortest known path from START to FINISH after mapping, only counted by runMapping
+			float seconds = 0.0f;
+			float maxSeconds = 0.0f; // the longest query, or slice for runAnytimeQueries, not counted by every run
+		};
+
+		// the Maze settings for one benchmark configuration, the defaults match Maze
+		struct Config
+		{
+			Maze::SearchEngine engine = Maze::BINARY_HEAP;
+			Maze::Heuristic heuristic = Maze::MANHATTAN;
+			bool incrementalPlanning = true;
+			bool corridorContraction = true;
+			bool deadEndPruning = true;
+			bool distanceTable = false; // builds the mouse's DistanceTable before mapMaze, only used by runMapping
+			bool floodFillMapping = false; // maps with mapMazeFloodFill instead of mapMaze, only used by runMapping
+			int openWallPercent = 0; // the share of the inner walls opened in every maze, only used by runKnownMazes
+			bool asyncPlanning = false; // plans on a PlannerThread while the mouse drives, only used by runMapping
+			float motionTimeScale = 0.0f; // see MouseBot::setMotionTimeScale, only used by runMapping
+			ExplorationPolicy* explorationPolicy = nullptr; // see MouseBot::setExplorationPolicy, only used by runMapping
+			float mappingGap = 0.0f; // see MouseBot::setMappingGap, only used by runMapping
+		};
+
+		// applies 'config' to 'maze'
+		static void configure( MazeBase& maze , const Config& config );
+
+		// runs random queries and START to FINISH queries on WIDTH x HEIGHT mazes where every wall is known
+		template < int WIDTH = MAZE_W , int HEIGHT = MAZE_H >
+		static Result runKnownMazes( const Config& config );
+
+		// runs the queries of runKnownMazes with the anytime search, one slice at a time until each is done
+		static Result runAnytimeQueries( const Config& config , int sliceExpansions , unsigned long sliceMicros );
+
+		// runs a complete mapMaze on each maze
+		static Result runMapping( const Config& config , int numMazes = NUM_MAZES );
+
+		// runs queries between random nodes at most SHORT_QUERY_RANGE apart on mazes where every wall is known
+		static Result runShortQueries( const Config& config );
+
+		// runs queries between opposite corners and between START and FINISH on mazes where every wall is known
+		static Result runLongQueries( const Config& config );
+
+		// runs the run queries on mazes where every wall is known, or on the mouse's maze after mapMaze
+		static Result runRunQueries( const Config& config , bool mapped );
+
+		// runs findRunPath and findPath from START to FINISH and back on 'maze'
+		static void runRunQueries( Maze& maze , Result& result );
+
+		// returns the time 'model' predicts for following 'path', starting while facing 'facing'
+		// the same rotations and straights as MouseBot::followPath
+		static float predictRunTime( const MotionModel& model , Maze::Path path , direction facing );
+
+		// adds the search counters of 'maze' to 'result'
+		static void addSearchStats( Result& result , const MazeBase& maze );
+		static void addSearchStats( Result& result , const MazeBase::SearchStats& stats );
+
+		// logs 'result' as one line, 'name' describes the configuration
+		static void logResult( const char* name , const Result& result );
+
+		static const int NUM_MAZES = 20; // number of seeded mazes used by each benchmark
+		static const int NUM_QUERIES = 50; // number of random queries run on each maze
+		static const int SHORT_QUERY_RANGE = 4; // the largest x and y distance of a short query
+		static const int NUM_RUNS = 5; // number of runs after mapping each maze in repeatedRuns
+		static const int NUM_MAPPING_MAZES = 200; // number of mazes mapped by the benchmarks that compare moves, which vary more than search costs
+
+		// returns the seed used to generate maze number 'i'
+		static unsigned int getSeed( int i );
+
+		// generates the virtual maze for 'seed'
+		// this matches the maze a MouseBot creates after srand( seed )
+		static void generateMaze( VirtualMaze& virtualMaze , unsigned int seed );
+
+		// opens about 'percent' of the inner walls of 'virtualMaze', the posts stay closed
+		static void openWalls( VirtualMaze& virtualMaze , int percent );
+
+		// copies the walls of 'virtualMaze' into 'maze' and marks every node as explored
+		template < int WIDTH , int HEIGHT >
+		static void loadVirtualMaze( MazeT< WIDTH , HEIGHT >& maze , const VirtualMaze& virtualMaze );
+
+		// returns a random position that is open in 'virtualMaze', a WIDTH x HEIGHT maze
+		template < int WIDTH = MAZE_W , int HEIGHT = MAZE_H >
+		static PositionVector randomOpenPosition( const VirtualMaze& virtualMaze );
+
+		// returns a random position that is open in 'virtualMaze' at most 'range' away from 'pos' in x and y
+		static PositionVector randomOpenPosition( const VirtualMaze& virtualMaze , PositionVector pos , int range );
+
+		// returns the number of heap allocations the simulator has made so far, 0 without BENCHMARK_ALLOCATIONS
+		static unsigned long getAllocationCount();
+
+		static const char* getEngineName( Maze::SearchEngine engine );
+		static const char* getHeuristicName( Maze::Heuristic heuristic );
+	};
+#endif
+}
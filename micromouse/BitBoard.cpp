@@ -0,0 +1,267 @@
+#include "BitBoard.h"
+#include <assert.h>
+
+#ifdef __MK20DX256__ // Teensy Compile
+#else // PC compile
+	#if defined( __AVX2__ )
+		#include <immintrin.h>
+		#define BITBOARD_AVX2
+	#elif defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+		#include <emmintrin.h>
+		#define BITBOARD_SSE2
+	#endif
+
+	#ifdef _MSC_VER
+		#include <intrin.h> // _BitScanForward
+	#endif
+#endif
+
+
+
+
+namespace Micromouse
+{
+#if defined( BITBOARD_AVX2 )
+	// shifts every row in 'v' one column up or down, the second argument selects the row size
+	static inline __m256i shiftLeft( __m256i v , unsigned int ) { return _mm256_slli_epi32( v , 1 ); }
+	static inline __m256i shiftLeft( __m256i v , unsigned long long ) { return _mm256_slli_epi64( v , 1 ); }
+	static inline __m256i shiftRight( __m256i v , unsigned int ) { return _mm256_srli_epi32( v , 1 ); }
+	static inline __m256i shiftRight( __m256i v , unsigned long long ) { return _mm256_srli_epi64( v , 1 ); }
+#elif defined( BITBOARD_SSE2 )
+	// shifts every row in 'v' one column up or down, the second argument selects the row size
+	static inline __m128i shiftLeft( __m128i v , unsigned int ) { return _mm_slli_epi32( v , 1 ); }
+	static inline __m128i shiftLeft( __m128i v , unsigned long long ) { return _mm_slli_epi64( v , 1 ); }
+	static inline __m128i shiftRight( __m128i v , unsigned int ) { return _mm_srli_epi32( v , 1 ); }
+	static inline __m128i shiftRight( __m128i v , unsigned long long ) { return _mm_srli_epi64( v , 1 ); }
+#endif
+
+
+
+	template < int WIDTH , int HEIGHT >
+	BitBoardT< WIDTH , HEIGHT >::BitBoardT()
+	{
+		for ( int i = 0; i < NUM_ROWS; i++ )
+		{
+			rows[ i ] = 0;
+		}
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	bool BitBoardT< WIDTH , HEIGHT >::get( int x , int y ) const
+	{
+		if ( x < 0 || x >= Geometry::NUM_NODES_W || y < 0 || y >= Geometry::NUM_NODES_H )
+		{
+			return false;
+		}
+
+		return ( rows[ FIRST_ROW + y ] >> x ) & 1;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	bool BitBoardT< WIDTH , HEIGHT >::getUnchecked( int x , int y ) const
+	{
+		// the rows before and after the grid are empty, and masking the shift wraps
+		// x = -1 and x = NUM_NODES_W onto the highest bit, which is always empty
+		return ( rows[ FIRST_ROW + y ] >> ( x & ( sizeof( Row ) * 8 - 1 ) ) ) & 1;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	void BitBoardT< WIDTH , HEIGHT >::set( int x , int y , bool flag )
+	{
+		if ( x < 0 || x >= Geometry::NUM_NODES_W || y < 0 || y >= Geometry::NUM_NODES_H )
+		{
+			return;
+		}
+
+		if ( flag )
+		{
+			rows[ FIRST_ROW + y ] |= static_cast< Row >( 1 ) << x;
+		}
+		else
+		{
+			rows[ FIRST_ROW + y ] &= ~( static_cast< Row >( 1 ) << x );
+		}
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	typename BitBoardT< WIDTH , HEIGHT >::Row BitBoardT< WIDTH , HEIGHT >::getRow( int y ) const
+	{
+		return rows[ FIRST_ROW + y ];
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	void BitBoardT< WIDTH , HEIGHT >::setRow( int y , Row bits )
+	{
+		assert( y >= 0 && y < Geometry::NUM_NODES_H );
+		assert( ( bits >> Geometry::NUM_NODES_W ) == 0 );
+
+		rows[ FIRST_ROW + y ] = bits;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	void BitBoardT< WIDTH , HEIGHT >::clear()
+	{
+		for ( int y = FIRST_ROW; y < FIRST_ROW + Geometry::NUM_NODES_H; y++ )
+		{
+			rows[ y ] = 0;
+		}
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	bool BitBoardT< WIDTH , HEIGHT >::any() const
+	{
+		Row bits = 0;
+
+		for ( int y = FIRST_ROW; y < FIRST_ROW + Geometry::NUM_NODES_H; y++ )
+		{
+			bits |= rows[ y ];
+		}
+
+		return bits != 0;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	void BitBoardT< WIDTH , HEIGHT >::andWith( const BitBoardT & other )
+	{
+		for ( int y = FIRST_ROW; y < FIRST_ROW + Geometry::NUM_NODES_H; y++ )
+		{
+			rows[ y ] &= other.rows[ y ];
+		}
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	void BitBoardT< WIDTH , HEIGHT >::andNot( const BitBoardT & other )
+	{
+		for ( int y = FIRST_ROW; y < FIRST_ROW + Geometry::NUM_NODES_H; y++ )
+		{
+			rows[ y ] &= ~other.rows[ y ];
+		}
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	void BitBoardT< WIDTH , HEIGHT >::orWith( const BitBoardT & other )
+	{
+		for ( int y = FIRST_ROW; y < FIRST_ROW + Geometry::NUM_NODES_H; y++ )
+		{
+			rows[ y ] |= other.rows[ y ];
+		}
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	void BitBoardT< WIDTH , HEIGHT >::expand( const BitBoardT & frontier , const BitBoardT & open , const BitBoardT & visited )
+	{
+		// the rows are written in blocks, so reading the frontier after writing a block would be wrong
+		assert( &frontier != this );
+
+		const Row* f = frontier.rows;
+		int y = FIRST_ROW;
+
+		// the vector loops may run past the last grid row into the empty rows after it,
+		// those stay empty because the same rows of 'open' are empty
+#if defined( BITBOARD_AVX2 )
+		for ( ; y < FIRST_ROW + Geometry::NUM_NODES_H; y += sizeof( __m256i ) / sizeof( Row ) )
+		{
+			__m256i middle = _mm256_loadu_si256( reinterpret_cast< const __m256i* >( f + y ) );
+			__m256i below = _mm256_loadu_si256( reinterpret_cast< const __m256i* >( f + y - 1 ) );
+			__m256i above = _mm256_loadu_si256( reinterpret_cast< const __m256i* >( f + y + 1 ) );
+
+			// a node is reached from the nodes to its left, right, below and above
+			__m256i grown = _mm256_or_si256(
+				_mm256_or_si256( middle , shiftLeft( middle , Row() ) ),
+				_mm256_or_si256( shiftRight( middle , Row() ) , _mm256_or_si256( below , above ) ) );
+
+			grown = _mm256_and_si256( grown , _mm256_loadu_si256( reinterpret_cast< const __m256i* >( open.rows + y ) ) );
+			grown = _mm256_andnot_si256( _mm256_loadu_si256( reinterpret_cast< const __m256i* >( visited.rows + y ) ) , grown );
+
+			_mm256_storeu_si256( reinterpret_cast< __m256i* >( rows + y ) , grown );
+		}
+#elif defined( BITBOARD_SSE2 )
+		for ( ; y < FIRST_ROW + Geometry::NUM_NODES_H; y += sizeof( __m128i ) / sizeof( Row ) )
+		{
+			__m128i middle = _mm_loadu_si128( reinterpret_cast< const __m128i* >( f + y ) );
+			__m128i below = _mm_loadu_si128( reinterpret_cast< const __m128i* >( f + y - 1 ) );
+			__m128i above = _mm_loadu_si128( reinterpret_cast< const __m128i* >( f + y + 1 ) );
+
+			// a node is reached from the nodes to its left, right, below and above
+			__m128i grown = _mm_or_si128(
+				_mm_or_si128( middle , shiftLeft( middle , Row() ) ),
+				_mm_or_si128( shiftRight( middle , Row() ) , _mm_or_si128( below , above ) ) );
+
+			grown = _mm_and_si128( grown , _mm_loadu_si128( reinterpret_cast< const __m128i* >( open.rows + y ) ) );
+			grown = _mm_andnot_si128( _mm_loadu_si128( reinterpret_cast< const __m128i* >( visited.rows + y ) ) , grown );
+
+			_mm_storeu_si128( reinterpret_cast< __m128i* >( rows + y ) , grown );
+		}
+#endif
+
+		// the portable loop, also finishes any rows the vector loops did not cover
+		for ( ; y < FIRST_ROW + Geometry::NUM_NODES_H; y++ )
+		{
+			// a node is reached from the nodes to its left, right, below and above
+			Row grown = f[ y ] | ( f[ y ] << 1 ) | ( f[ y ] >> 1 ) | f[ y - 1 ] | f[ y + 1 ];
+
+			rows[ y ] = grown & open.rows[ y ] & ~visited.rows[ y ];
+		}
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	int BitBoardT< WIDTH , HEIGHT >::lowestBit( unsigned int bits )
+	{
+		assert( bits != 0 );
+
+#ifdef _MSC_VER
+		unsigned long index;
+		_BitScanForward( &index , bits );
+		return index;
+#else
+		return __builtin_ctz( bits );
+#endif
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	int BitBoardT< WIDTH , HEIGHT >::lowestBit( unsigned long long bits )
+	{
+		assert( bits != 0 );
+
+		// 32 bit targets have no 64 bit bit scan
+		unsigned int low = static_cast< unsigned int >( bits );
+
+		return low != 0 ? lowestBit( low ) : 32 + lowestBit( static_cast< unsigned int >( bits >> 32 ) );
+	}
+
+
+
+	// the classic and the half size competition mazes, only the simulator builds the half size one
+	template class BitBoardT< 16 , 16 >;
+
+#ifdef __MK20DX256__ // Teensy Compile
+#else // PC compile
+	template class BitBoardT< 32 , 32 >;
+#endif
+}
@@ -0,0 +1,97 @@
+#pragma once
+#include "Vector.h"
+#include "MazeGeometry.h"
+
+
+
+namespace Micromouse
+{
+	// the word that holds one row of a BitBoard, 32 bits when the row fits and 64 bits otherwise
+	template < bool WIDE >
+	struct BitBoardRow
+	{
+		typedef unsigned int Type;
+	};
+
+	template <>
+	struct BitBoardRow< true >
+	{
+		typedef unsigned long long Type;
+	};
+
+
+
+	// A set of node positions stored as one word per row of the node grid,
+	// bit x of row y is the node at ( x , y ). Whole rows are combined with word
+	// operations, so a breadth first wavefront grows by one step across the
+	// entire maze with a few shifts and masks instead of one node at a time.
+	//
+	// The board is sized for a WIDTH x HEIGHT maze at compile time, see MazeGeometry.
+	// On the PC expand() uses SSE2 or AVX2 when the compiler targets them,
+	// everywhere else, including the Teensy, it uses the portable scalar loop.
+	template < int WIDTH , int HEIGHT >
+	class BitBoardT
+	{
+	public:
+		typedef MazeGeometry< WIDTH , HEIGHT > Geometry;
+		typedef typename BitBoardRow< ( Geometry::NUM_NODES_W >= 32 ) >::Type Row;
+
+		// creates an empty board
+		BitBoardT();
+
+		// returns true if ( x , y ) is in the set, false if it is not or is outside the grid
+		bool get( int x , int y ) const;
+
+		// the same as get() without the bounds check,
+		// x and y may be at most one position outside the grid in any direction
+		bool getUnchecked( int x , int y ) const;
+
+		// adds or removes ( x , y ), positions outside the grid are ignored
+		void set( int x , int y , bool flag );
+
+		// returns the bits of row 'y', bit x is the node at ( x , y )
+		Row getRow( int y ) const;
+
+		// replaces the bits of row 'y', the bits past the last column must be 0
+		void setRow( int y , Row bits );
+
+		// removes every position
+		void clear();
+
+		// returns true if any position is in the set
+		bool any() const;
+
+		// keeps only the positions that are also in 'other'
+		void andWith( const BitBoardT& other );
+
+		// removes the positions that are in 'other'
+		void andNot( const BitBoardT& other );
+
+		// adds the positions that are in 'other'
+		void orWith( const BitBoardT& other );
+
+		// sets this board to the positions one straight move from 'frontier'
+		// that are in 'open' and not in 'visited', one step of a breadth first search
+		// 'frontier' must be a different board than this one
+		void expand( const BitBoardT& frontier , const BitBoardT& open , const BitBoardT& visited );
+
+		// returns the position of the lowest set bit in 'bits', which must not be 0
+		static int lowestBit( unsigned int bits );
+		static int lowestBit( unsigned long long bits );
+
+	private:
+		// the highest bit of every row stays empty, getUnchecked() reads it for the columns outside the grid
+		static_assert( Geometry::NUM_NODES_W < static_cast< int >( sizeof( Row ) * 8 ) , "a row of nodes must fit in a Row with one bit to spare" );
+
+		// the grid rows are stored from rows[ 1 ], with an empty row before and after
+		// and enough empty rows to read 8 rows at a time, so the vector loops in expand()
+		// can read the rows above and below without bounds checks
+		static const int FIRST_ROW = 1;
+		static const int NUM_ROWS = ( ( Geometry::NUM_NODES_H + 7 ) / 8 ) * 8 + 2;
+
+		Row rows[ NUM_ROWS ];
+	};
+
+	// the board for the maze size the mouse is built for
+	typedef BitBoardT< MAZE_W , MAZE_H > BitBoard;
+}
@@ -0,0 +1,167 @@
+#include "BucketQueue.h"
+#include <assert.h>
+
+
+
+
+namespace Micromouse
+{
+	BucketQueue::BucketQueue( int capacity , int keySpan ) :
+		capacity( capacity ),
+		numBuckets( keySpan )
+	{
+		assert( capacity > 0 && capacity < END_OF_LIST );
+		assert( keySpan > 0 );
+
+		buckets = new unsigned short[ numBuckets ];
+		next = new unsigned short[ capacity ];
+		previous = new unsigned short[ capacity ];
+		keys = new int[ capacity ];
+
+		for ( int b = 0; b < numBuckets; b++ )
+		{
+			buckets[ b ] = END_OF_LIST;
+		}
+
+		for ( int i = 0; i < capacity; i++ )
+		{
+			keys[ i ] = NOT_IN_QUEUE;
+		}
+	}
+
+
+
+	BucketQueue::~BucketQueue()
+	{
+		delete[] buckets;
+		delete[] next;
+		delete[] previous;
+		delete[] keys;
+	}
+
+
+
+	void BucketQueue::push( int index , int key )
+	{
+		assert( index >= 0 && index < capacity );
+		assert( key >= 0 );
+
+		remove( index );
+
+		if ( count == 0 || key < lowestKey )
+		{
+			lowestKey = key;
+		}
+
+		// the ring of buckets can only hold keys within 'numBuckets' of each other
+		assert( key - lowestKey < numBuckets );
+
+		int b = getBucket( key );
+
+		// add to the front of the bucket
+		next[ index ] = buckets[ b ];
+		previous[ index ] = END_OF_LIST;
+
+		if ( buckets[ b ] != END_OF_LIST )
+		{
+			previous[ buckets[ b ] ] = index;
+		}
+
+		buckets[ b ] = index;
+		keys[ index ] = key;
+		count++;
+	}
+
+
+
+	int BucketQueue::pop()
+	{
+		assert( count > 0 );
+
+		// step forward to the first bucket that is not empty
+		while ( buckets[ getBucket( lowestKey ) ] == END_OF_LIST )
+		{
+			lowestKey++;
+		}
+
+		int index = buckets[ getBucket( lowestKey ) ];
+		remove( index );
+
+		return index;
+	}
+
+
+
+	void BucketQueue::remove( int index )
+	{
+		assert( index >= 0 && index < capacity );
+
+		if ( keys[ index ] == NOT_IN_QUEUE )
+		{
+			return;
+		}
+
+		// unlink 'index' from its bucket
+		if ( previous[ index ] != END_OF_LIST )
+		{
+			next[ previous[ index ] ] = next[ index ];
+		}
+		else
+		{
+			buckets[ getBucket( keys[ index ] ) ] = next[ index ];
+		}
+
+		if ( next[ index ] != END_OF_LIST )
+		{
+			previous[ next[ index ] ] = previous[ index ];
+		}
+
+		keys[ index ] = NOT_IN_QUEUE;
+		count--;
+	}
+
+
+
+	bool BucketQueue::contains( int index ) const
+	{
+		return keys[ index ] != NOT_IN_QUEUE;
+	}
+
+
+
+	int BucketQueue::size() const
+	{
+		return count;
+	}
+
+
+
+	bool BucketQueue::empty() const
+	{
+		return count == 0;
+	}
+
+
+
+	void BucketQueue::clear()
+	{
+		for ( int b = 0; b < numBuckets; b++ )
+		{
+			for ( int index = buckets[ b ]; index != END_OF_LIST; index = next[ index ] )
+			{
+				keys[ index ] = NOT_IN_QUEUE;
+			}
+
+			buckets[ b ] = END_OF_LIST;
+		}
+
+		count = 0;
+	}
+
+
+
+	int BucketQueue::getBucket( int key ) const
+	{
+		return key % numBuckets;
+	}
+}
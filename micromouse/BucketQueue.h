@@ -0,0 +1,69 @@
+#pragma once
+
+
+
+namespace Micromouse
+{
+	// A bucket priority queue (Dial's algorithm) used as the open list for pathfinding.
+	// The items are node indices ( 0 <= index < capacity ) with small integer keys.
+	// Every key has its own bucket, a doubly linked list threaded through the indices,
+	// so push, remove and changing a key are O(1) and pop only has to step over empty buckets.
+	//
+	// The keys removed by pop() must never decrease and every key in the queue must
+	// be less than 'keySpan' larger than the last key popped. Then the buckets can be
+	// reused in a ring instead of allocating one for every possible path cost.
+	class BucketQueue
+	{
+	public:
+		// 'capacity' is the number of distinct indices the queue can hold
+		// 'keySpan' is the largest difference between any two keys in the queue, plus one
+		BucketQueue( int capacity , int keySpan );
+		~BucketQueue();
+
+		// a copy would free the arrays it owns twice
+		BucketQueue( const BucketQueue& ) = delete;
+		BucketQueue& operator=( const BucketQueue& ) = delete;
+
+		// adds 'index' to the queue with the priority 'key'
+		// if 'index' is already in the queue its key is changed instead
+		void push( int index , int key );
+
+		// removes an index with the lowest key and returns it
+		// indices with equal keys are returned last in, first out
+		// calling on an empty queue will result in an error
+		int pop();
+
+		// removes 'index' from the queue if it is in the queue
+		void remove( int index );
+
+		// returns true if 'index' is currently in the queue
+		bool contains( int index ) const;
+
+		// returns the number of indices in the queue
+		int size() const;
+
+		// returns true when the queue is empty, false otherwise
+		bool empty() const;
+
+		// removes every index from the queue
+		void clear();
+
+	private:
+		static const unsigned short END_OF_LIST = 0xFFFF;
+		static const int NOT_IN_QUEUE = -1;
+
+		// returns the bucket that holds 'key'
+		int getBucket( int key ) const;
+
+		int capacity;
+		int numBuckets;
+		int count = 0;
+
+		int lowestKey = 0; // no key in the queue is lower than this
+
+		unsigned short* buckets; // buckets[ b ] is the first index in bucket b
+		unsigned short* next; // next[ index ] is the index after 'index' in its bucket
+		unsigned short* previous; // previous[ index ] is the index before 'index' in its bucket
+		int* keys; // keys[ index ] is the priority of 'index', or NOT_IN_QUEUE
+	};
+}
@@ -0,0 +1,571 @@
+#include "CellMaze.h"
+#include "Maze.h"
+#include "VirtualMaze.h"
+#include "BitBoard.h"
+#include <assert.h>
+
+
+
+
+namespace Micromouse
+{
+	// the sides of a cell
+	static const direction sideDirections[] = { N , E , S , W };
+
+
+
+	template < int WIDTH , int HEIGHT >
+	CellMazeT< WIDTH , HEIGHT >::CellMazeT()
+	{
+		for ( int i = 0; i < WIDTH * HEIGHT; i++ )
+		{
+			cells[ i ] = 0;
+			distances[ i ] = UNREACHED;
+		}
+
+		for ( int i = 0; i < ( WIDTH * HEIGHT + 7 ) / 8; i++ )
+		{
+			explored[ i ] = 0;
+			removed[ i ] = 0;
+		}
+
+		for ( int x = 0; x < WIDTH; x++ )
+		{
+			cells[ getIndex( x , 0 ) ] |= WALL_S | KNOWN_S;
+			cells[ getIndex( x , HEIGHT - 1 ) ] |= WALL_N | KNOWN_N;
+		}
+
+		for ( int y = 0; y < HEIGHT; y++ )
+		{
+			cells[ getIndex( 0 , y ) ] |= WALL_W | KNOWN_W;
+			cells[ getIndex( WIDTH - 1 , y ) ] |= WALL_E | KNOWN_E;
+		}
+
+		// the center posts are open and unexplored, like in a new MazeT
+		posts = 0;
+
+		for ( int x = WIDTH - 2; x <= WIDTH; x++ )
+		{
+			for ( int y = HEIGHT - 2; y <= HEIGHT; y++ )
+			{
+				if ( getPostIndex( x , y ) >= 0 )
+				{
+					posts |= 1 << ( 2 * getPostIndex( x , y ) );
+				}
+			}
+		}
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	void CellMazeT< WIDTH , HEIGHT >::fromMaze( const MazeT< WIDTH , HEIGHT >& maze )
+	{
+		*this = CellMazeT();
+
+		for ( int x = 0; x < WIDTH; x++ )
+		{
+			for ( int y = 0; y < HEIGHT; y++ )
+			{
+				PositionVector cell( 2 * x , 2 * y );
+
+				setCellBit( explored , x , y , maze.isExplored( cell ) );
+				setCellBit( removed , x , y , !maze.hasNode( cell ) );
+
+				// only the east and north sides, the others are set as the sides of the neighbors
+				PositionVector edges[] = { cell + E , cell + N };
+				direction sides[] = { E , N };
+
+				for ( int i = 0; i < 2; i++ )
+				{
+					if ( !Geometry::isValidPosition( edges[ i ].x() , edges[ i ].y() ) )
+					{
+						continue; // an outer wall
+					}
+
+					if ( !maze.hasNode( edges[ i ] ) )
+					{
+						setSide( x , y , sides[ i ] , true , true );
+					}
+					else if ( maze.isExplored( edges[ i ] ) )
+					{
+						setSide( x , y , sides[ i ] , false , true );
+					}
+				}
+			}
+		}
+
+		for ( int x = WIDTH - 2; x <= WIDTH; x++ )
+		{
+			for ( int y = HEIGHT - 2; y <= HEIGHT; y++ )
+			{
+				int post = getPostIndex( x , y );
+
+				if ( post >= 0 )
+				{
+					posts &= ~( 3 << ( 2 * post ) );
+					posts |= ( maze.hasNode( PositionVector( x , y ) ) ? 1 : 0 ) << ( 2 * post );
+					posts |= ( maze.isExplored( PositionVector( x , y ) ) ? 2 : 0 ) << ( 2 * post );
+				}
+			}
+		}
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	void CellMazeT< WIDTH , HEIGHT >::toMaze( MazeT< WIDTH , HEIGHT >& maze ) const
+	{
+		maze.reset();
+
+		for ( int x = 0; x < Geometry::NUM_NODES_W; x++ )
+		{
+			for ( int y = 0; y < Geometry::NUM_NODES_H; y++ )
+			{
+				if ( !Geometry::isValidPosition( x , y ) )
+				{
+					continue;
+				}
+
+				PositionVector pos( x , y );
+				bool open;
+				bool known;
+
+				if ( x % 2 == 0 && y % 2 == 0 )
+				{
+					open = !getCellBit( removed , x / 2 , y / 2 );
+					known = isExplored( x / 2 , y / 2 );
+				}
+				else if ( x % 2 == 1 && y % 2 == 1 )
+				{
+					int post = getPostIndex( x , y );
+					open = ( posts >> ( 2 * post ) & 1 ) != 0;
+					known = ( posts >> ( 2 * post ) & 2 ) != 0;
+				}
+				else
+				{
+					// the edge is the east or north side of the cell below or west of it
+					direction side = x % 2 == 1 ? E : N;
+					unsigned char cell = cells[ getIndex( x / 2 , y / 2 ) ];
+					known = ( cell & getKnownBit( side ) ) != 0;
+					open = !known || ( cell & getWallBit( side ) ) == 0;
+				}
+
+				if ( !open )
+				{
+					maze.removeNode( pos );
+				}
+				else if ( known )
+				{
+					maze.setExplored( pos );
+				}
+			}
+		}
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	void CellMazeT< WIDTH , HEIGHT >::fromVirtualMaze( const VirtualMaze& virtualMaze )
+	{
+		assert( virtualMaze.getWidth() == Geometry::NUM_NODES_W && virtualMaze.getHeight() == Geometry::NUM_NODES_H );
+
+		*this = CellMazeT();
+
+		for ( int x = 0; x < WIDTH; x++ )
+		{
+			for ( int y = 0; y < HEIGHT; y++ )
+			{
+				PositionVector cell( 2 * x , 2 * y );
+
+				setCellBit( explored , x , y , virtualMaze.isExplored( cell ) );
+				setCellBit( removed , x , y , !virtualMaze.isOpen( cell ) );
+
+				PositionVector edges[] = { cell + E , cell + N };
+				direction sides[] = { E , N };
+
+				for ( int i = 0; i < 2; i++ )
+				{
+					if ( Geometry::isValidPosition( edges[ i ].x() , edges[ i ].y() ) )
+					{
+						setSide( x , y , sides[ i ] , !virtualMaze.isOpen( edges[ i ] ) , virtualMaze.isExplored( edges[ i ] ) );
+					}
+				}
+			}
+		}
+
+		for ( int x = WIDTH - 2; x <= WIDTH; x++ )
+		{
+			for ( int y = HEIGHT - 2; y <= HEIGHT; y++ )
+			{
+				int post = getPostIndex( x , y );
+
+				if ( post >= 0 )
+				{
+					posts &= ~( 3 << ( 2 * post ) );
+					posts |= ( virtualMaze.isOpen( x , y ) ? 1 : 0 ) << ( 2 * post );
+					posts |= ( virtualMaze.isExplored( x , y ) ? 2 : 0 ) << ( 2 * post );
+				}
+			}
+		}
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	void CellMazeT< WIDTH , HEIGHT >::toVirtualMaze( VirtualMaze& virtualMaze ) const
+	{
+		assert( virtualMaze.getWidth() == Geometry::NUM_NODES_W && virtualMaze.getHeight() == Geometry::NUM_NODES_H );
+
+		for ( int x = 0; x < Geometry::NUM_NODES_W; x++ )
+		{
+			for ( int y = 0; y < Geometry::NUM_NODES_H; y++ )
+			{
+				bool open;
+				bool known;
+
+				if ( x % 2 == 0 && y % 2 == 0 )
+				{
+					open = !getCellBit( removed , x / 2 , y / 2 );
+					known = isExplored( x / 2 , y / 2 );
+				}
+				else if ( x % 2 == 1 && y % 2 == 1 )
+				{
+					// the posts outside the center are walls that generateRandomMaze() explores
+					int post = getPostIndex( x , y );
+					open = post >= 0 && ( posts >> ( 2 * post ) & 1 ) != 0;
+					known = post < 0 || ( posts >> ( 2 * post ) & 2 ) != 0;
+				}
+				else
+				{
+					direction side = x % 2 == 1 ? E : N;
+					unsigned char cell = cells[ getIndex( x / 2 , y / 2 ) ];
+					open = ( cell & getWallBit( side ) ) == 0;
+					known = ( cell & getKnownBit( side ) ) != 0;
+				}
+
+				virtualMaze.setOpen( open , x , y );
+				virtualMaze.setExplored( known , x , y );
+			}
+		}
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	unsigned char CellMazeT< WIDTH , HEIGHT >::getCell( int x , int y ) const
+	{
+		return cells[ getIndex( x , y ) ];
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	void CellMazeT< WIDTH , HEIGHT >::setWall( int x , int y , direction dir , bool wall )
+	{
+		int nx = x + Geometry::DX[ dir ];
+		int ny = y + Geometry::DY[ dir ];
+
+		if ( nx >= 0 && nx < WIDTH && ny >= 0 && ny < HEIGHT )
+		{
+			setSide( x , y , dir , wall , true );
+		}
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	bool CellMazeT< WIDTH , HEIGHT >::isExplored( int x , int y ) const
+	{
+		return getCellBit( explored , x , y );
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	void CellMazeT< WIDTH , HEIGHT >::setExplored( int x , int y )
+	{
+		setCellBit( explored , x , y , true );
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	void CellMazeT< WIDTH , HEIGHT >::flood( int x , int y , bool isMapping )
+	{
+		floodUntil( x , y , -1 , -1 , isMapping );
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	unsigned short CellMazeT< WIDTH , HEIGHT >::getFloodDistance( int x , int y ) const
+	{
+		return distances[ getIndex( x , y ) ];
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	bool CellMazeT< WIDTH , HEIGHT >::findPath( PositionVector start , PositionVector end , Path& path , bool isMapping )
+	{
+		assert( start.x() % 2 == 0 && start.y() % 2 == 0 && end.x() % 2 == 0 && end.y() % 2 == 0 );
+
+		path.clear();
+
+		int x = end.x() / 2;
+		int y = end.y() / 2;
+
+		floodUntil( start.x() / 2 , start.y() / 2 , x , y , isMapping );
+
+		if ( distances[ getIndex( x , y ) ] == UNREACHED )
+		{
+			return false;
+		}
+
+		direction travelDir = NONE;
+		int magnitude = 0;
+
+		// walk back from end down the distances, the steps are added in reverse
+		while ( distances[ getIndex( x , y ) ] != 0 )
+		{
+			unsigned short parentDistance = distances[ getIndex( x , y ) ] - 1;
+			direction back = NONE;
+
+			for ( int d = 0; d < 4; d++ )
+			{
+				direction dir = sideDirections[ d ];
+				unsigned char cell = cells[ getIndex( x , y ) ];
+
+				// the parent had to reach this cell, so only the side between them matters
+				bool open = ( cell & getKnownBit( dir ) ) != 0 ? ( cell & getWallBit( dir ) ) == 0 : isMapping;
+
+				if ( open && distances[ getIndex( x + Geometry::DX[ dir ] , y + Geometry::DY[ dir ] ) ] == parentDistance )
+				{
+					back = dir;
+
+					// keep going straight when there is a choice, so the path has fewer steps
+					if ( dir + S == travelDir )
+					{
+						break;
+					}
+				}
+			}
+
+			assert( back != NONE );
+
+			if ( back + S != travelDir )
+			{
+				if ( travelDir != NONE )
+				{
+					path.addStep( DirectionVector( travelDir , magnitude ) );
+				}
+
+				travelDir = back + S;
+				magnitude = 0;
+			}
+
+			// a move between two cells crosses the edge between them
+			magnitude += 2;
+			x += Geometry::DX[ back ];
+			y += Geometry::DY[ back ];
+		}
+
+		if ( travelDir != NONE )
+		{
+			path.addStep( DirectionVector( travelDir , magnitude ) );
+		}
+
+		return true;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	int CellMazeT< WIDTH , HEIGHT >::getIndex( int x , int y )
+	{
+		return x * HEIGHT + y;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	int CellMazeT< WIDTH , HEIGHT >::getPostIndex( int x , int y )
+	{
+		if ( x % 2 == 0 || y % 2 == 0 || !Geometry::isValidPosition( x , y ) )
+		{
+			return -1;
+		}
+
+		// isValidPosition() only allows posts around the center, at most two in each direction
+		return ( ( x - ( WIDTH - 2 ) ) / 2 ) * 2 + ( y - ( HEIGHT - 2 ) ) / 2;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	bool CellMazeT< WIDTH , HEIGHT >::getCellBit( const unsigned char* bits , int x , int y )
+	{
+		int index = getIndex( x , y );
+
+		return ( bits[ index / 8 ] >> ( index % 8 ) & 1 ) != 0;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	void CellMazeT< WIDTH , HEIGHT >::setCellBit( unsigned char* bits , int x , int y , bool flag )
+	{
+		int index = getIndex( x , y );
+
+		bits[ index / 8 ] = ( bits[ index / 8 ] & ~( 1 << ( index % 8 ) ) ) | ( flag ? 1 : 0 ) << ( index % 8 );
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	unsigned char CellMazeT< WIDTH , HEIGHT >::getWallBit( direction dir )
+	{
+		return dir == N ? WALL_N : dir == E ? WALL_E : dir == S ? WALL_S : WALL_W;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	unsigned char CellMazeT< WIDTH , HEIGHT >::getKnownBit( direction dir )
+	{
+		return getWallBit( dir ) << 4;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	void CellMazeT< WIDTH , HEIGHT >::setSide( int x , int y , direction dir , bool wall , bool known )
+	{
+		int nx = x + Geometry::DX[ dir ];
+		int ny = y + Geometry::DY[ dir ];
+
+		assert( nx >= 0 && nx < WIDTH && ny >= 0 && ny < HEIGHT ); // the outer walls are fixed
+
+		unsigned char bits = ( wall ? getWallBit( dir ) : 0 ) | ( known ? getKnownBit( dir ) : 0 );
+		unsigned char otherBits = ( wall ? getWallBit( dir + S ) : 0 ) | ( known ? getKnownBit( dir + S ) : 0 );
+
+		unsigned char& cell = cells[ getIndex( x , y ) ];
+		unsigned char& other = cells[ getIndex( nx , ny ) ];
+
+		cell = ( cell & ~( getWallBit( dir ) | getKnownBit( dir ) ) ) | bits;
+		other = ( other & ~( getWallBit( dir + S ) | getKnownBit( dir + S ) ) ) | otherBits;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	bool CellMazeT< WIDTH , HEIGHT >::canMove( int x , int y , direction dir , bool isMapping ) const
+	{
+		unsigned char cell = cells[ getIndex( x , y ) ];
+
+		// the outer walls are known, so a move that is not blocked stays inside the maze
+		if ( ( cell & getKnownBit( dir ) ) != 0 ? ( cell & getWallBit( dir ) ) != 0 : !isMapping )
+		{
+			return false;
+		}
+
+		int nx = x + Geometry::DX[ dir ];
+		int ny = y + Geometry::DY[ dir ];
+
+		return isMapping ? !getCellBit( removed , nx , ny ) : isExplored( nx , ny );
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	void CellMazeT< WIDTH , HEIGHT >::floodUntil( int x , int y , int endX , int endY , bool isMapping )
+	{
+		// the cells of the wavefront, a bit per cell
+		static const int NUM_WORDS = ( WIDTH * HEIGHT + 31 ) / 32;
+
+		unsigned int frontier[ NUM_WORDS ] = {};
+		unsigned int next[ NUM_WORDS ];
+
+		for ( int i = 0; i < WIDTH * HEIGHT; i++ )
+		{
+			distances[ i ] = UNREACHED;
+		}
+
+		int startIndex = getIndex( x , y );
+		int endIndex = endX < 0 ? -1 : getIndex( endX , endY );
+
+		distances[ startIndex ] = 0;
+		frontier[ startIndex / 32 ] = 1u << ( startIndex % 32 );
+
+		if ( startIndex == endIndex )
+		{
+			return;
+		}
+
+		// every cell in the wavefront is the same number of cells from the start
+		for ( unsigned short distance = 1; ; distance++ )
+		{
+			bool grew = false;
+
+			for ( int w = 0; w < NUM_WORDS; w++ )
+			{
+				next[ w ] = 0;
+			}
+
+			for ( int w = 0; w < NUM_WORDS; w++ )
+			{
+				for ( unsigned int bits = frontier[ w ]; bits != 0; bits &= bits - 1 )
+				{
+					int index = w * 32 + BitBoardT< WIDTH , HEIGHT >::lowestBit( bits );
+					int cx = index / HEIGHT;
+					int cy = index % HEIGHT;
+
+					for ( int d = 0; d < 4; d++ )
+					{
+						direction dir = sideDirections[ d ];
+
+						if ( !canMove( cx , cy , dir , isMapping ) )
+						{
+							continue;
+						}
+
+						int neighbor = getIndex( cx + Geometry::DX[ dir ] , cy + Geometry::DY[ dir ] );
+
+						if ( distances[ neighbor ] == UNREACHED )
+						{
+							distances[ neighbor ] = distance;
+							next[ neighbor / 32 ] |= 1u << ( neighbor % 32 );
+							grew = true;
+
+							if ( neighbor == endIndex )
+							{
+								return;
+							}
+						}
+					}
+				}
+			}
+
+			if ( !grew )
+			{
+				return;
+			}
+
+			for ( int w = 0; w < NUM_WORDS; w++ )
+			{
+				frontier[ w ] = next[ w ];
+			}
+		}
+	}
+
+
+
+	// the classic and the half size competition mazes, only the simulator builds the half size one
+	template class CellMazeT< 16 , 16 >;
+
+#ifdef __MK20DX256__ // Teensy Compile
+#else // PC compile
+	template class CellMazeT< 32 , 32 >;
+#endif
+}
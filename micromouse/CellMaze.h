@@ -0,0 +1,127 @@
+#pragma once
+#include "Vector.h"
+#include "MazeGeometry.h"
+#include "Path.h"
+
+
+
+namespace Micromouse
+{
+	template < int WIDTH , int HEIGHT > class MazeT;
+	class VirtualMaze;
+
+	// The maze as one byte per cell, the classic micromouse representation, with a flood fill solver.
+	//
+	// Each cell has a wall bit and a known bit for each of its four sides. A wall between two
+	// cells is stored in both of them, and the outer walls are always known. MazeT spends a node on
+	// every edge, and most of its memory on the search state of every node, while the whole map here
+	// is WIDTH * HEIGHT bytes plus a bit per cell for the cells the mouse has explored, a bit per cell
+	// for the cells removed from the maze and a byte for the center posts, 321 bytes for the 16x16 maze.
+	// The flood fill adds 2 bytes per cell for the distances, so planning fits in under 1 KB,
+	// see Benchmark::cellMaze.
+	//
+	// The conversions are lossless for the mazes the mouse maps and the mazes VirtualMaze generates.
+	// A MazeT edge that is explored is a known opening, a removed edge is a known wall and any other
+	// edge is unknown. A VirtualMaze keeps whether each edge is open apart from whether it is explored,
+	// so the wall bit of an unknown side holds it. A cell is only removed from a MazeT by
+	// MazeT::removeExcessFinshNodes, or closed in a VirtualMaze, and a path never enters one.
+	// The posts outside the center are walls in every maze, so they are not stored.
+	//
+	// The cells are addressed by cell coordinates, ( x , y ) is the node at ( 2x , 2y ), except for
+	// findPath, which takes node positions and fills a Path in nodes like MazeT::findPath.
+	template < int WIDTH , int HEIGHT >
+	class CellMazeT
+	{
+	public:
+		typedef MazeGeometry< WIDTH , HEIGHT > Geometry;
+		typedef PathT< Geometry::MAX_PATH_STEPS > Path;
+
+		// the bits of a cell, a wall bit only says there is a wall once its known bit is set
+		static const unsigned char WALL_N = 0x01 , WALL_E = 0x02 , WALL_S = 0x04 , WALL_W = 0x08;
+		static const unsigned char KNOWN_N = 0x10 , KNOWN_E = 0x20 , KNOWN_S = 0x40 , KNOWN_W = 0x80;
+
+		// the flood distance of a cell the flood did not reach
+		static const unsigned short UNREACHED = 0xFFFF;
+
+		// creates a maze where only the outer walls are known and no cell is explored
+		CellMazeT();
+
+		// replaces this maze with the walls and explored nodes of 'maze'
+		void fromMaze( const MazeT< WIDTH , HEIGHT >& maze );
+
+		// resets 'maze' and gives it the walls and explored cells of this maze
+		void toMaze( MazeT< WIDTH , HEIGHT >& maze ) const;
+
+		// replaces this maze with 'virtualMaze', which must be the size of the node grid
+		void fromVirtualMaze( const VirtualMaze& virtualMaze );
+
+		// sets every node of 'virtualMaze', which must be the size of the node grid, from this maze
+		void toVirtualMaze( VirtualMaze& virtualMaze ) const;
+
+		// returns the byte of the cell at ( x , y )
+		unsigned char getCell( int x , int y ) const;
+
+		// records whether there is a wall on the side 'dir' of the cell at ( x , y ), and on the other
+		// side of it, and marks it known, 'dir' must be N, E, S or W and the outer walls do not change
+		void setWall( int x , int y , direction dir , bool wall );
+
+		// the cells the mouse has explored, like MazeT::setExplored on a cell
+		bool isExplored( int x , int y ) const;
+		void setExplored( int x , int y );
+
+		// sets the flood distance of every cell to the number of cells from the cell at ( x , y ),
+		// through the known openings and the explored cells, or every side not known to be a wall if mapping
+		void flood( int x , int y , bool isMapping );
+
+		// returns the flood distance of the cell at ( x , y ) from the last flood, or UNREACHED
+		unsigned short getFloodDistance( int x , int y ) const;
+
+		// finds a shortest path between the cells at 'start' and 'end', node positions, like MazeT::findPath
+		// returns false and leaves 'path' empty if there is no path
+		bool findPath( PositionVector start , PositionVector end , Path& path , bool isMapping = false );
+
+	private:
+		// returns the index of the cell at ( x , y )
+		static int getIndex( int x , int y );
+
+		// returns the index of the center post at the node ( x , y ), or -1 if it is not one
+		static int getPostIndex( int x , int y );
+
+		// reads and writes the bit of the cell at ( x , y ) in 'bits', a bit per cell
+		static bool getCellBit( const unsigned char* bits , int x , int y );
+		static void setCellBit( unsigned char* bits , int x , int y , bool flag );
+
+		// returns the wall and known bits of the side 'dir', which must be N, E, S or W
+		static unsigned char getWallBit( direction dir );
+		static unsigned char getKnownBit( direction dir );
+
+		// sets the bits of the side 'dir' of the cell at ( x , y ) and of the cell on the other side
+		void setSide( int x , int y , direction dir , bool wall , bool known );
+
+		// returns true if a path may move from the cell at ( x , y ) to its neighbor in the direction 'dir'
+		bool canMove( int x , int y , direction dir , bool isMapping ) const;
+
+		// floods from the cell at ( x , y ) until the cell at ( endX , endY ) is reached,
+		// or every cell it can reach if endX is -1
+		void floodUntil( int x , int y , int endX , int endY , bool isMapping );
+
+		// the walls and known bits of each cell
+		unsigned char cells[ WIDTH * HEIGHT ];
+
+		// a bit for each cell, set if it has been explored
+		unsigned char explored[ ( WIDTH * HEIGHT + 7 ) / 8 ];
+
+		// a bit for each cell, set if it has been removed from the maze
+		unsigned char removed[ ( WIDTH * HEIGHT + 7 ) / 8 ];
+
+		// two bits for each of the center posts, at most four, the low one is set if the post is open
+		// and the high one if it is explored
+		unsigned char posts;
+
+		// the distances of the last flood
+		unsigned short distances[ WIDTH * HEIGHT ];
+	};
+
+	// the cell maze for the maze size the mouse is built for
+	typedef CellMazeT< MAZE_W , MAZE_H > CellMaze;
+}
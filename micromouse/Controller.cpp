@@ -3,6 +3,7 @@
 #include <vector>
 #include "Timer.h"
 #include "ButtonFlag.h"
+#include "Benchmark.h"
 
 #ifdef __MK20DX256__ // Teensy Compile
 	#include "WProgram.h"
@@ -34,11 +35,12 @@ namespace Micromouse
 	{
 		// DEBUG CODE GOES IN HERE!
 
-		mouse.mapMaze();
+		logC(INFO) << "Mapped maze in: " << mouse.mapMaze() << " moves";
 		//mouse.runMaze();
 		//mouse.testIR();
 		//mouse.testMotors();
 		//mouse.testRotate();
+		//Benchmark::runAll();
 
 		// DEBUG CODE GOES IN HERE!
 	}
@@ -111,6 +113,8 @@ namespace Micromouse
 
 	void Controller::runState()
 	{
+		int moves; // the moves made by the last mapping run
+
 		switch (state)
 		{
 		case NONE:
@@ -124,7 +128,7 @@ namespace Micromouse
 			blinkLEDCountdown(3);
 
 			mouse.resetToOrigin();
-			mouse.mapMaze();
+			moves = mouse.mapMaze();
 
 			if (buttonFlag)
 			{
@@ -132,6 +136,7 @@ namespace Micromouse
 			}
 			else
 			{
+				logC(INFO) << "Mapped maze in: " << moves << " moves";
 				doneMap = true;
 				state = RUN_MAZE;
 				return;
@@ -0,0 +1,270 @@
+#include "CorridorGraph.h"
+#include "Maze.h"
+#include <assert.h>
+
+
+
+
+namespace Micromouse
+{
+	// the moves a corridor can make, every move of a search over explored nodes is straight
+	static const direction straightDirections[] = { N , E , S , W };
+
+
+
+	template < int WIDTH , int HEIGHT >
+	CorridorGraphT< WIDTH , HEIGHT >::CorridorGraphT( MazeT< WIDTH , HEIGHT >& maze , NodeHeap& openList ) :
+		maze( maze ),
+		openList( openList )
+	{
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	void CorridorGraphT< WIDTH , HEIGHT >::updateNode( PositionVector pos )
+	{
+		// a node is a junction depending on itself and its neighbors, so only these can change
+		for ( int d = -1; d < 4; d++ )
+		{
+			int x = pos.x() + ( d < 0 ? 0 : Geometry::DX[ straightDirections[ d ] ] );
+			int y = pos.y() + ( d < 0 ? 0 : Geometry::DY[ straightDirections[ d ] ] );
+
+			if ( Geometry::isValidPosition( x , y ) )
+			{
+				junctions.set( x , y , isJunction( x , y ) );
+			}
+		}
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	void CorridorGraphT< WIDTH , HEIGHT >::reset()
+	{
+		junctions.clear();
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	int CorridorGraphT< WIDTH , HEIGHT >::findPath( PositionVector start , const Board& ends , unsigned long& nodesExpanded , const Board* skipped )
+	{
+		assert( maze.isExplored( start ) );
+
+		const int NO_NODE = MazeT< WIDTH , HEIGHT >::NO_NODE;
+
+		// a corridor ends at a junction, or early at the start or an end inside it
+		Board stops = junctions;
+		stops.orWith( ends );
+		stops.set( start.x() , start.y() , true );
+
+		int startIndex = Geometry::getIndex( start.x() , start.y() );
+		int endIndex = NO_NODE;
+
+		openList.clear();
+
+		maze.touchNode( startIndex );
+		maze.nodeG[ startIndex ] = 0;
+		openList.push( startIndex , 0 );
+
+		// Dijkstra's algorithm over the junctions, the nodes of a corridor are never on the open list
+		while ( !openList.empty() )
+		{
+			int index = openList.pop();
+			maze.setFlag( maze.nodeClosed , index , true );
+			nodesExpanded++;
+
+			int x = index / Geometry::NUM_NODES_H;
+			int y = index % Geometry::NUM_NODES_H;
+
+			if ( ends.getUnchecked( x , y ) )
+			{
+				endIndex = index;
+				break;
+			}
+
+			for ( int d = 0; d < 4; d++ )
+			{
+				direction dir = straightDirections[ d ];
+
+				if ( !maze.nodeExplored.getUnchecked( x + Geometry::DX[ dir ] , y + Geometry::DY[ dir ] ) )
+				{
+					continue;
+				}
+
+				int numMoves;
+				int next = followCorridor( index , dir , stops , numMoves );
+
+				// a corridor that ends in a skipped node leads into a skipped part of the maze
+				if ( skipped != nullptr && skipped->getUnchecked( next / Geometry::NUM_NODES_H , next % Geometry::NUM_NODES_H ) )
+				{
+					continue;
+				}
+
+				maze.touchNode( next );
+
+				if ( maze.getFlag( maze.nodeClosed , next ) )
+				{
+					continue;
+				}
+
+				int g = maze.nodeG[ index ] + numMoves * STRAIGHT_COST;
+
+				// the parent of a junction is the junction at the other end of the corridor,
+				// and its direction is the direction the corridor leaves the parent until linkCorridor()
+				if ( g < maze.nodeG[ next ] )
+				{
+					maze.nodeG[ next ] = g;
+					maze.nodeParent[ next ] = index;
+					maze.nodeDir[ next ] = dir;
+					openList.push( next , g );
+				}
+			}
+		}
+
+		if ( endIndex == NO_NODE )
+		{
+			return NO_NODE;
+		}
+
+		// fill in the parents along each corridor of the path, from the end back to start
+		int index = endIndex;
+
+		while ( index != startIndex )
+		{
+			int parent = maze.nodeParent[ index ];
+			linkCorridor( parent , static_cast< direction >( maze.nodeDir[ index ] ) , index );
+			index = parent;
+		}
+
+		return endIndex;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	int CorridorGraphT< WIDTH , HEIGHT >::getNumJunctions() const
+	{
+		int numJunctions = 0;
+
+		for ( int y = 0; y < Geometry::NUM_NODES_H; y++ )
+		{
+			for ( typename Board::Row bits = junctions.getRow( y ); bits != 0; bits &= bits - 1 )
+			{
+				numJunctions++;
+			}
+		}
+
+		return numJunctions;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	bool CorridorGraphT< WIDTH , HEIGHT >::isJunction( int x , int y ) const
+	{
+		if ( !maze.nodeExplored.getUnchecked( x , y ) )
+		{
+			return false;
+		}
+
+		int numNeighbors = 0;
+
+		for ( int d = 0; d < 4; d++ )
+		{
+			if ( maze.nodeExplored.getUnchecked( x + Geometry::DX[ straightDirections[ d ] ] , y + Geometry::DY[ straightDirections[ d ] ] ) )
+			{
+				numNeighbors++;
+			}
+		}
+
+		return numNeighbors != 2;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	direction CorridorGraphT< WIDTH , HEIGHT >::getCorridorDirection( int x , int y , direction dir ) const
+	{
+		direction back = dir + S;
+
+		for ( int d = 0; d < 4; d++ )
+		{
+			direction next = straightDirections[ d ];
+
+			if ( next != back && maze.nodeExplored.getUnchecked( x + Geometry::DX[ next ] , y + Geometry::DY[ next ] ) )
+			{
+				return next;
+			}
+		}
+
+		assert( false ); // the node has a second explored neighbor unless it is a junction
+		return NONE;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	int CorridorGraphT< WIDTH , HEIGHT >::followCorridor( int index , direction dir , const Board& stops , int& numMoves ) const
+	{
+		int x = index / Geometry::NUM_NODES_H;
+		int y = index % Geometry::NUM_NODES_H;
+
+		numMoves = 0;
+
+		for ( ;; )
+		{
+			x += Geometry::DX[ dir ];
+			y += Geometry::DY[ dir ];
+			index += Geometry::INDEX_OFFSET[ dir ];
+			numMoves++;
+
+			if ( stops.getUnchecked( x , y ) )
+			{
+				return index;
+			}
+
+			dir = getCorridorDirection( x , y , dir );
+		}
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	void CorridorGraphT< WIDTH , HEIGHT >::linkCorridor( int index , direction dir , int endIndex )
+	{
+		int x = index / Geometry::NUM_NODES_H;
+		int y = index % Geometry::NUM_NODES_H;
+
+		for ( ;; )
+		{
+			x += Geometry::DX[ dir ];
+			y += Geometry::DY[ dir ];
+
+			int next = index + Geometry::INDEX_OFFSET[ dir ];
+
+			maze.touchNode( next );
+			maze.nodeParent[ next ] = index;
+			maze.nodeDir[ next ] = dir;
+
+			if ( next == endIndex )
+			{
+				return;
+			}
+
+			dir = getCorridorDirection( x , y , dir );
+			index = next;
+		}
+	}
+
+
+
+	// the classic and the half size competition mazes, only the simulator builds the half size one
+	template class CorridorGraphT< 16 , 16 >;
+
+#ifdef __MK20DX256__ // Teensy Compile
+#else // PC compile
+	template class CorridorGraphT< 32 , 32 >;
+#endif
+}
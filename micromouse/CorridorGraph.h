@@ -0,0 +1,76 @@
+#pragma once
+#include "Vector.h"
+#include "NodeListener.h"
+#include "NodeHeap.h"
+#include "MazeGeometry.h"
+#include "BitBoard.h"
+
+
+
+namespace Micromouse
+{
+	template < int WIDTH , int HEIGHT > class MazeT;
+
+	// The explored maze with its corridors contracted, for searches over explored nodes.
+	//
+	// Most explored nodes have exactly two explored neighbors, so a search can only pass
+	// through them. The graph keeps the other explored nodes, the junctions, in a BitBoard
+	// and a corridor between two junctions is one edge weighted by its number of moves.
+	// A search only puts junctions on the open list, the nodes of a corridor are followed
+	// without touching it, and the parents along the corridors are only filled in for the path.
+	//
+	// The edges are not stored, following one only reads nodeExplored, so the graph is
+	// kept up to date by updateNode() rechecking the few nodes whose neighbors changed.
+	// The search writes the maze's node arrays, so MazeT::createPath builds the path as usual.
+	// The maze lends its NodeHeap, like the RunPlanner.
+	template < int WIDTH , int HEIGHT >
+	class CorridorGraphT : public NodeListener
+	{
+	public:
+		typedef MazeGeometry< WIDTH , HEIGHT > Geometry;
+		typedef BitBoardT< WIDTH , HEIGHT > Board;
+
+		// 'openList' must hold every node index of 'maze'
+		CorridorGraphT( MazeT< WIDTH , HEIGHT >& maze , NodeHeap& openList );
+
+		// rechecks 'pos' and its neighbors after 'pos' was added, removed or explored
+		void updateNode( PositionVector pos );
+
+		// forgets every junction, for a maze with nothing explored
+		void reset();
+
+		// finds the shortest path over explored nodes from 'start', which must be explored,
+		// to the nearest of 'ends' and sets the maze's parents back to 'start'
+		// returns the index of the end reached, or MazeT::NO_NODE if no end can be reached
+		// 'nodesExpanded' is increased by the number of junctions expanded
+		// the corridors that lead into 'skipped' are not searched, it may be nullptr
+		int findPath( PositionVector start , const Board& ends , unsigned long& nodesExpanded , const Board* skipped );
+
+		// returns the number of junctions
+		int getNumJunctions() const;
+
+	private:
+		// returns true if the node at ( x , y ) is explored and does not have exactly two explored neighbors
+		bool isJunction( int x , int y ) const;
+
+		// returns the direction a corridor leaves the node at ( x , y ) when it was entered moving 'dir'
+		// the node must have exactly two explored neighbors
+		direction getCorridorDirection( int x , int y , direction dir ) const;
+
+		// follows the corridor from the node at 'index' leaving it in the direction 'dir'
+		// until it reaches a node in 'stops', returns that node's index and sets 'numMoves'
+		int followCorridor( int index , direction dir , const Board& stops , int& numMoves ) const;
+
+		// sets the parents along the corridor from 'index' leaving in the direction 'dir' to 'endIndex'
+		void linkCorridor( int index , direction dir , int endIndex );
+
+		MazeT< WIDTH , HEIGHT >& maze;
+
+		NodeHeap& openList;
+
+		Board junctions;
+	};
+
+	// the graph for the maze size the mouse is built for
+	typedef CorridorGraphT< MAZE_W , MAZE_H > CorridorGraph;
+}
@@ -0,0 +1,150 @@
+#include "DeadEndPruner.h"
+#include "Maze.h"
+
+
+
+
+namespace Micromouse
+{
+	template < int WIDTH , int HEIGHT >
+	DeadEndPrunerT< WIDTH , HEIGHT >::DeadEndPrunerT( const Board& nodes ) :
+		nodes( nodes )
+	{
+		kept.set( PositionVector::START.x() , PositionVector::START.y() , true );
+		kept.set( MazeT< WIDTH , HEIGHT >::getFinish().x() , MazeT< WIDTH , HEIGHT >::getFinish().y() , true );
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	void DeadEndPrunerT< WIDTH , HEIGHT >::updateNode( PositionVector pos )
+	{
+		const direction straightDirections[] = { N , E , S , W };
+
+		stale = true;
+
+		if ( !nodes.get( pos.x() , pos.y() ) )
+		{
+			// losing a node only makes more dead ends
+			pruned.set( pos.x() , pos.y() , false );
+			return;
+		}
+
+		int numNeighbors = 0;
+
+		for ( int d = 0; d < 4; d++ )
+		{
+			if ( nodes.getUnchecked( pos.x() + Geometry::DX[ straightDirections[ d ] ] , pos.y() + Geometry::DY[ straightDirections[ d ] ] ) )
+			{
+				numNeighbors++;
+			}
+		}
+
+		// a new node between two nodes can join dead ends into a corridor
+		if ( numNeighbors >= 2 )
+		{
+			pruned.clear();
+		}
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	void DeadEndPrunerT< WIDTH , HEIGHT >::reset()
+	{
+		pruned.clear();
+		deepPruned.clear();
+		stale = true;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	const typename DeadEndPrunerT< WIDTH , HEIGHT >::Board& DeadEndPrunerT< WIDTH , HEIGHT >::getPruned()
+	{
+		if ( stale )
+		{
+			prune();
+			stale = false;
+		}
+
+		return pruned;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	const typename DeadEndPrunerT< WIDTH , HEIGHT >::Board& DeadEndPrunerT< WIDTH , HEIGHT >::getDeepPruned()
+	{
+		getPruned();
+
+		return deepPruned;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	void DeadEndPrunerT< WIDTH , HEIGHT >::prune()
+	{
+		typedef typename Board::Row Row;
+
+		const int NUM_NODES_H = Geometry::NUM_NODES_H;
+
+		bool changed = true;
+
+		// each pass prunes the tips of the dead ends, and the rows it has already
+		// passed, so it repeats until a pass prunes nothing
+		while ( changed )
+		{
+			changed = false;
+
+			for ( int y = 0; y < NUM_NODES_H; y++ )
+			{
+				// the nodes that are not pruned, in this row and the rows above and below
+				Row alive = nodes.getRow( y ) & ~pruned.getRow( y );
+				Row above = y + 1 < NUM_NODES_H ? nodes.getRow( y + 1 ) & ~pruned.getRow( y + 1 ) : 0;
+				Row below = y > 0 ? nodes.getRow( y - 1 ) & ~pruned.getRow( y - 1 ) : 0;
+
+				// bit x of each is set if the neighbor of x on that side is alive
+				Row west = alive << 1;
+				Row east = alive >> 1;
+
+				Row twoNeighbors = ( above & below ) | ( west & east ) | ( ( above | below ) & ( west | east ) );
+				Row deadEnds = alive & ~twoNeighbors & ~kept.getRow( y );
+
+				if ( deadEnds != 0 )
+				{
+					pruned.setRow( y , pruned.getRow( y ) | deadEnds );
+					changed = true;
+				}
+			}
+		}
+
+		// the deep dead ends are the nodes more than two moves from the rest
+		Board reached = nodes;
+		reached.andNot( pruned );
+
+		Board frontier = reached;
+		Board next;
+
+		for ( int i = 0; i < 2; i++ )
+		{
+			next.expand( frontier , nodes , reached );
+			reached.orWith( next );
+			frontier = next;
+		}
+
+		deepPruned = nodes;
+		deepPruned.andNot( reached );
+	}
+
+
+
+	// the classic and the half size competition mazes, only the simulator builds the half size one
+	template class DeadEndPrunerT< 16 , 16 >;
+
+#ifdef __MK20DX256__ // Teensy Compile
+#else // PC compile
+	template class DeadEndPrunerT< 32 , 32 >;
+#endif
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include "Vector.h"
+#include "NodeListener.h"
+#include "MazeGeometry.h"
+#include "BitBoard.h"
+
+
+
+namespace Micromouse
+{
+	// Marks the dead ends of a set of nodes, the nodes no shortest path between START
+	// and FINISH can use, so the run searches can skip them. The maze keeps one for
+	// its explored nodes and one for its present nodes, see MazeT::getSkippedNodes.
+	//
+	// A node with at most one neighbor in the set that is not pruned is a dead end, unless it
+	// is START or FINISH. Pruning it can make its neighbor a dead end, so whole branches are
+	// filled in from their tips, a row of the BitBoard at a time. What is left is the part of
+	// the maze with a loop or START or FINISH on every side, and the pruned nodes hang off it
+	// as trees. A path between two nodes that are not pruned would have to leave a tree the way
+	// it came in, so no shortest path between them enters one.
+	//
+	// The fastest path is not always a shortest one, it can run a straight into the mouth of
+	// a dead end to line up a diagonal out of it. That can only reach two moves into a dead end,
+	// a straight in and a diagonal out need the same corridor to be a line and a staircase,
+	// so the run searches only skip the deep dead ends, past those two moves.
+	//
+	// Losing nodes from the set only prunes more, so the pruning carries on from where it
+	// was, except when a node joins two neighbors in the set, which can connect two dead ends
+	// into a corridor and makes the pruning start over. Either way it runs when it is next used.
+	template < int WIDTH , int HEIGHT >
+	class DeadEndPrunerT : public NodeListener
+	{
+	public:
+		typedef MazeGeometry< WIDTH , HEIGHT > Geometry;
+		typedef BitBoardT< WIDTH , HEIGHT > Board;
+
+		// 'nodes' is the set to prune, it is read when the pruned nodes are asked for
+		DeadEndPrunerT( const Board& nodes );
+
+		// notes that 'pos' may have joined or left the set
+		void updateNode( PositionVector pos );
+
+		// forgets every pruned node, after the set was cleared
+		void reset();
+
+		// returns the pruned nodes, pruning the dead ends made since the last call first
+		const Board& getPruned();
+
+		// returns the pruned nodes more than two moves from the nodes that are not pruned
+		const Board& getDeepPruned();
+
+	private:
+		// prunes dead ends until none are left and finds the deep ones
+		void prune();
+
+		const Board& nodes;
+
+		Board pruned;
+		Board deepPruned;
+
+		// the nodes that are never pruned, START and FINISH
+		Board kept;
+
+		// set when the set changed since the last prune()
+		bool stale = true;
+	};
+
+	// the pruner for the maze size the mouse is built for
+	typedef DeadEndPrunerT< MAZE_W , MAZE_H > DeadEndPruner;
+}
@@ -0,0 +1,482 @@
+#include "DistanceTable.h"
+#include "Maze.h"
+#include <assert.h>
+
+
+
+
+namespace Micromouse
+{
+	// the moves between the table nodes and the edges, every move over explored nodes is straight
+	static const direction straightDirections[] = { N , E , S , W };
+
+
+
+	template < int WIDTH , int HEIGHT >
+	DistanceTableT< WIDTH , HEIGHT >::DistanceTableT( const MazeT< WIDTH , HEIGHT >& maze , bool allPairs ) :
+		maze( maze )
+	{
+		if ( allPairs )
+		{
+			numSources = NUM_TABLE_NODES;
+		}
+		else
+		{
+			numSources = 2;
+			sources[ 0 ] = getTableIndex( PositionVector::START.x() , PositionVector::START.y() );
+			sources[ 1 ] = getTableIndex( MazeT< WIDTH , HEIGHT >::getFinish().x() , MazeT< WIDTH , HEIGHT >::getFinish().y() );
+		}
+
+		rows = new unsigned short[ numSources * NUM_TABLE_NODES ];
+		queue = new unsigned short[ NUM_TABLE_NODES ];
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	DistanceTableT< WIDTH , HEIGHT >::~DistanceTableT()
+	{
+		delete[] rows;
+		delete[] queue;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	void DistanceTableT< WIDTH , HEIGHT >::updateNode( PositionVector /*pos*/ )
+	{
+		// the next lookup finds what changed from the explored nodes
+		dirty = true;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	void DistanceTableT< WIDTH , HEIGHT >::reset()
+	{
+		included.clear();
+		stale = true;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	bool DistanceTableT< WIDTH , HEIGHT >::hasRows( PositionVector from , PositionVector to ) const
+	{
+		return numSources == NUM_TABLE_NODES || hasRows( from ) || hasRows( to );
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	int DistanceTableT< WIDTH , HEIGHT >::getDistance( PositionVector from , PositionVector to )
+	{
+		if ( stale || dirty )
+		{
+			repair();
+		}
+
+		if ( !maze.nodeExplored.get( from.x() , from.y() ) || !maze.nodeExplored.get( to.x() , to.y() ) )
+		{
+			return -1;
+		}
+
+		if ( from == to )
+		{
+			return 0;
+		}
+
+		int fromEnds[ MAX_ENDS ];
+		int fromMoves;
+		int numFromEnds = getEnds( from , fromEnds , fromMoves );
+
+		int toEnds[ MAX_ENDS ];
+		int toMoves;
+		int numToEnds = getEnds( to , toEnds , toMoves );
+
+		// the rows of 'from', or of 'to' since the distances are the same both ways
+		unsigned short* fromRows[ MAX_ENDS ];
+		bool haveRows = true;
+
+		for ( int i = 0; i < numFromEnds && haveRows; i++ )
+		{
+			fromRows[ i ] = getRow( fromEnds[ i ] );
+			haveRows = fromRows[ i ] != nullptr;
+		}
+
+		if ( !haveRows )
+		{
+			haveRows = true;
+
+			for ( int i = 0; i < numToEnds && haveRows; i++ )
+			{
+				fromRows[ i ] = getRow( toEnds[ i ] );
+				haveRows = fromRows[ i ] != nullptr;
+			}
+
+			if ( haveRows )
+			{
+				for ( int i = 0; i < MAX_ENDS; i++ )
+				{
+					int end = fromEnds[ i ];
+					fromEnds[ i ] = toEnds[ i ];
+					toEnds[ i ] = end;
+				}
+
+				int numEnds = numFromEnds;
+				numFromEnds = numToEnds;
+				numToEnds = numEnds;
+			}
+		}
+
+		assert( haveRows ); // see hasRows()
+
+		if ( !haveRows )
+		{
+			return -1;
+		}
+
+		int minHops = NO_HOPS;
+
+		for ( int i = 0; i < numFromEnds; i++ )
+		{
+			for ( int j = 0; j < numToEnds; j++ )
+			{
+				if ( fromRows[ i ][ toEnds[ j ] ] < minHops )
+				{
+					minHops = fromRows[ i ][ toEnds[ j ] ];
+				}
+			}
+		}
+
+		if ( minHops == NO_HOPS )
+		{
+			return -1;
+		}
+
+		return fromMoves + 2 * minHops + toMoves;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	int DistanceTableT< WIDTH , HEIGHT >::getTableIndex( int x , int y )
+	{
+		if ( x % 2 == 0 && y % 2 == 0 )
+		{
+			return ( x / 2 ) * HEIGHT + y / 2;
+		}
+
+		if ( x % 2 == 1 && y % 2 == 1 && Geometry::isValidPosition( x , y ) )
+		{
+			// isValidPosition() only allows posts around the center
+			return WIDTH * HEIGHT + ( x - ( WIDTH - 2 ) ) * 3 + y - ( HEIGHT - 2 );
+		}
+
+		return -1;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	PositionVector DistanceTableT< WIDTH , HEIGHT >::getTablePos( int t )
+	{
+		if ( t < WIDTH * HEIGHT )
+		{
+			return PositionVector( ( t / HEIGHT ) * 2 , ( t % HEIGHT ) * 2 );
+		}
+
+		t -= WIDTH * HEIGHT;
+
+		return PositionVector( WIDTH - 2 + t / 3 , HEIGHT - 2 + t % 3 );
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	unsigned short* DistanceTableT< WIDTH , HEIGHT >::getRow( int t ) const
+	{
+		if ( numSources == NUM_TABLE_NODES )
+		{
+			return rows + t * NUM_TABLE_NODES;
+		}
+
+		for ( int i = 0; i < numSources; i++ )
+		{
+			if ( sources[ i ] == t )
+			{
+				return rows + i * NUM_TABLE_NODES;
+			}
+		}
+
+		return nullptr;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	bool DistanceTableT< WIDTH , HEIGHT >::hasRows( PositionVector pos ) const
+	{
+		int ends[ MAX_ENDS ];
+		int moves;
+		int numEnds = getEnds( pos , ends , moves );
+
+		for ( int i = 0; i < numEnds; i++ )
+		{
+			if ( getRow( ends[ i ] ) == nullptr )
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	int DistanceTableT< WIDTH , HEIGHT >::getEnds( PositionVector pos , int* ends , int& moves ) const
+	{
+		int t = getTableIndex( pos.x() , pos.y() );
+
+		if ( t >= 0 )
+		{
+			ends[ 0 ] = t;
+			moves = 0;
+			return 1;
+		}
+
+		int numEnds = 0;
+		moves = 1;
+
+		for ( int d = 0; d < 4; d++ )
+		{
+			int x = pos.x() + Geometry::DX[ straightDirections[ d ] ];
+			int y = pos.y() + Geometry::DY[ straightDirections[ d ] ];
+
+			if ( maze.nodeExplored.getUnchecked( x , y ) )
+			{
+				assert( getTableIndex( x , y ) >= 0 ); // the neighbors of an edge are cells and posts
+				ends[ numEnds++ ] = getTableIndex( x , y );
+			}
+		}
+
+		return numEnds;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	int DistanceTableT< WIDTH , HEIGHT >::getHops( int t , int* hops ) const
+	{
+		PositionVector pos = getTablePos( t );
+		int numHops = 0;
+
+		for ( int d = 0; d < 4; d++ )
+		{
+			PositionVector edge = pos + straightDirections[ d ];
+
+			if ( !maze.nodeExplored.getUnchecked( edge.x() , edge.y() ) )
+			{
+				continue;
+			}
+
+			// the edges around the center post turn into the cells beside them
+			int ends[ MAX_ENDS ];
+			int moves;
+			int numEnds = getEnds( edge , ends , moves );
+
+			for ( int i = 0; i < numEnds; i++ )
+			{
+				if ( ends[ i ] != t )
+				{
+					hops[ numHops++ ] = ends[ i ];
+				}
+			}
+		}
+
+		return numHops;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	void DistanceTableT< WIDTH , HEIGHT >::fillRow( unsigned short* row , const int* starts , int numStarts )
+	{
+		for ( int t = 0; t < NUM_TABLE_NODES; t++ )
+		{
+			row[ t ] = NO_HOPS;
+		}
+
+		int head = 0;
+		int tail = 0;
+
+		for ( int i = 0; i < numStarts; i++ )
+		{
+			row[ starts[ i ] ] = 0;
+			queue[ tail++ ] = starts[ i ];
+		}
+
+		// a breadth first search reaches each table node once
+		while ( head < tail )
+		{
+			int t = queue[ head++ ];
+			int hops[ MAX_HOPS ];
+			int numHops = getHops( t , hops );
+
+			for ( int i = 0; i < numHops; i++ )
+			{
+				if ( row[ hops[ i ] ] == NO_HOPS )
+				{
+					row[ hops[ i ] ] = row[ t ] + 1;
+					queue[ tail++ ] = hops[ i ];
+				}
+			}
+		}
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	void DistanceTableT< WIDTH , HEIGHT >::relaxFrom( unsigned short* row , int t )
+	{
+		int head = 0;
+		int tail = 0;
+
+		queue[ tail++ ] = t;
+
+		// the nodes are lowered in the order of their new hops, so each one is lowered once
+		while ( head < tail )
+		{
+			int u = queue[ head++ ];
+			int hops[ MAX_HOPS ];
+			int numHops = getHops( u , hops );
+
+			for ( int i = 0; i < numHops; i++ )
+			{
+				if ( row[ u ] + 1 < row[ hops[ i ] ] )
+				{
+					row[ hops[ i ] ] = row[ u ] + 1;
+					queue[ tail++ ] = hops[ i ];
+				}
+			}
+		}
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	void DistanceTableT< WIDTH , HEIGHT >::addHop( int a , int b )
+	{
+		for ( int i = 0; i < numSources; i++ )
+		{
+			unsigned short* row = rows + i * NUM_TABLE_NODES;
+
+			if ( row[ a ] != NO_HOPS && row[ a ] + 1 < row[ b ] )
+			{
+				row[ b ] = row[ a ] + 1;
+				relaxFrom( row , b );
+			}
+			else if ( row[ b ] != NO_HOPS && row[ b ] + 1 < row[ a ] )
+			{
+				row[ a ] = row[ b ] + 1;
+				relaxFrom( row , a );
+			}
+		}
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	void DistanceTableT< WIDTH , HEIGHT >::addExplored( PositionVector pos )
+	{
+		int t = getTableIndex( pos.x() , pos.y() );
+
+		if ( t >= 0 )
+		{
+			int hops[ MAX_HOPS ];
+			int numHops = getHops( t , hops );
+
+			for ( int i = 0; i < numHops; i++ )
+			{
+				addHop( t , hops[ i ] );
+			}
+		}
+		else
+		{
+			// an edge joins every pair of table nodes beside it
+			int ends[ MAX_ENDS ];
+			int moves;
+			int numEnds = getEnds( pos , ends , moves );
+
+			for ( int i = 0; i < numEnds; i++ )
+			{
+				for ( int j = i + 1; j < numEnds; j++ )
+				{
+					addHop( ends[ i ] , ends[ j ] );
+				}
+			}
+		}
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	void DistanceTableT< WIDTH , HEIGHT >::repair()
+	{
+		Board lost = included;
+		lost.andNot( maze.nodeExplored );
+
+		if ( stale || lost.any() )
+		{
+			rebuild();
+			return;
+		}
+
+		Board added = maze.nodeExplored;
+		added.andNot( included );
+
+		included = maze.nodeExplored;
+		dirty = false;
+
+		// the hops are added against every explored node, so the new nodes can be added in any order
+		for ( int y = 0; y < Geometry::NUM_NODES_H; y++ )
+		{
+			typename Board::Row bits = added.getRow( y );
+
+			while ( bits != 0 )
+			{
+				int x = Board::lowestBit( bits );
+				bits &= bits - 1;
+
+				addExplored( PositionVector( x , y ) );
+			}
+		}
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	void DistanceTableT< WIDTH , HEIGHT >::rebuild()
+	{
+		for ( int i = 0; i < numSources; i++ )
+		{
+			int source = numSources == NUM_TABLE_NODES ? i : sources[ i ];
+			fillRow( rows + i * NUM_TABLE_NODES , &source , 1 );
+		}
+
+		included = maze.nodeExplored;
+		stale = false;
+		dirty = false;
+	}
+
+
+
+	// the classic and the half size competition mazes, only the simulator builds the half size one
+	template class DistanceTableT< 16 , 16 >;
+
+#ifdef __MK20DX256__ // Teensy Compile
+#else // PC compile
+	template class DistanceTableT< 32 , 32 >;
+#endif
+}
@@ -0,0 +1,139 @@
+#pragma once
+#include "Vector.h"
+#include "NodeListener.h"
+#include "MazeGeometry.h"
+#include "BitBoard.h"
+
+
+
+namespace Micromouse
+{
+	template < int WIDTH , int HEIGHT > class MazeT;
+
+	// The number of moves between explored nodes, kept up to date as the maze is explored
+	// so MazeT::getDistance can look them up instead of searching.
+	//
+	// Every move over explored nodes goes between a cell, or a post in the center, and an edge,
+	// so the table only holds the table nodes, the cells and the center posts, and a hop between
+	// two of them through an explored edge is two moves. A node on an edge is one move from
+	// the table nodes on either side of it.
+	//
+	// The table holds the distances from its sources to every table node, one row per source.
+	// With every table node as a source each lookup is O(1), but the rows take
+	// NUM_TABLE_NODES^2 * 2 bytes, 140 KB for the 16x16 maze and 2.1 MB for the 32x32 maze,
+	// so only the host keeps every pair. The Teensy only keeps the rows for START and FINISH,
+	// about 1.5 KB with the search queue, and MazeT::getDistance answers the lookups between
+	// two other nodes with findPath, see hasRows().
+	//
+	// The rows are only repaired by the next lookup, so a maze that changes without being looked up
+	// pays for nothing but a flag. Exploring a node only adds hops, so each row is repaired with a
+	// breadth first search from every hop that shortened it. Losing an explored node rebuilds every row,
+	// that only happens if a wall is found in a place that was thought to be open.
+	template < int WIDTH , int HEIGHT >
+	class DistanceTableT : public NodeListener
+	{
+	public:
+		typedef MazeGeometry< WIDTH , HEIGHT > Geometry;
+		typedef BitBoardT< WIDTH , HEIGHT > Board;
+
+		// the cells, and the 3 x 3 nodes around the center where the posts can be nodes
+		static const int NUM_TABLE_NODES = WIDTH * HEIGHT + 9;
+
+		// when 'allPairs' is true every table node is a source, otherwise only START and FINISH are
+		DistanceTableT( const MazeT< WIDTH , HEIGHT >& maze , bool allPairs );
+		~DistanceTableT();
+
+		// a copy would free the arrays it owns twice
+		DistanceTableT( const DistanceTableT& ) = delete;
+		DistanceTableT& operator=( const DistanceTableT& ) = delete;
+
+		// marks the rows for repair after 'pos' was added, removed or explored
+		void updateNode( PositionVector pos );
+
+		// forgets every distance, for a maze with nothing explored
+		void reset();
+
+		// returns true if the table has the rows to look up the distance between 'from' and 'to',
+		// always true when every table node is a source, otherwise only from or to START and FINISH
+		bool hasRows( PositionVector from , PositionVector to ) const;
+
+		// returns the number of moves of the shortest path over explored nodes from 'from' to 'to',
+		// or -1 if there is none or either of them is not explored
+		// hasRows( from , to ) must be true unless one of them is not explored
+		int getDistance( PositionVector from , PositionVector to );
+
+	private:
+		// the distance of a table node that has not been reached, in hops
+		static const unsigned short NO_HOPS = 0xFFFF;
+
+		// the most table nodes beside one edge, and one hop from one table node
+		static const int MAX_ENDS = 4;
+		static const int MAX_HOPS = 4 * MAX_ENDS;
+
+		// returns the index of the table node at ( x , y ), or -1 if it is not a table node
+		static int getTableIndex( int x , int y );
+
+		// returns the position of table node 't'
+		static PositionVector getTablePos( int t );
+
+		// returns the row of source 't', or nullptr if 't' is not a source
+		unsigned short* getRow( int t ) const;
+
+		// returns true if every explored table node next to 'pos' is a source
+		bool hasRows( PositionVector pos ) const;
+
+		// returns the explored table nodes next to 'pos', 'pos' itself if it is one,
+		// and sets 'moves' to the moves from 'pos' to each of them
+		int getEnds( PositionVector pos , int* ends , int& moves ) const;
+
+		// returns the explored table nodes one hop from table node 't', some may be repeated
+		int getHops( int t , int* hops ) const;
+
+		// sets 'row' to the hops from each of 'starts' to every table node
+		void fillRow( unsigned short* row , const int* starts , int numStarts );
+
+		// lowers the hops in 'row' that get shorter through table node 't', which was just lowered
+		void relaxFrom( unsigned short* row , int t );
+
+		// updates every row for a new hop between table nodes 'a' and 'b'
+		void addHop( int a , int b );
+
+		// updates every row for the hops through 'pos', which was just explored
+		void addExplored( PositionVector pos );
+
+		// brings the rows up to date with the explored nodes of the maze
+		void repair();
+
+		// fills every row from scratch
+		void rebuild();
+
+		const MazeT< WIDTH , HEIGHT >& maze;
+
+		int numSources;
+
+		// source i is table node 'sources[ i ]', only used when not every table node is a source
+		int sources[ 2 ];
+
+		unsigned short* rows; // rows[ i * NUM_TABLE_NODES + t ] is the hops from source i to t
+		unsigned short* queue; // the breadth first search queue
+
+		// the explored nodes the rows include
+		Board included;
+
+		// set when the rows were never filled and must be rebuilt
+		bool stale = true;
+
+		// set when the maze changed since the rows were repaired
+		bool dirty = false;
+	};
+
+	// the table for the maze size the mouse is built for
+	typedef DistanceTableT< MAZE_W , MAZE_H > DistanceTable;
+
+#ifdef __MK20DX256__ // Teensy Compile
+	// every pair does not fit, see DistanceTableT
+	const bool DISTANCE_TABLE_ALL_PAIRS = false;
+#else // PC compile
+	const bool DISTANCE_TABLE_ALL_PAIRS = true;
+#endif
+}
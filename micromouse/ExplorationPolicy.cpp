@@ -0,0 +1,199 @@
+#include "ExplorationPolicy.h"
+#include <math.h>
+
+
+
+namespace Micromouse
+{
+	// the neighbors the mouse sees from a node
+	static const direction lookDirections[] = { N , E , S , W };
+
+
+
+	bool NearestPassagePolicy::selectPassage( Maze& maze , PositionVector position ,
+		const Maze::Path& /*route*/ , const NodePairList& passages , Maze::Path& path , NodePair& target )
+	{
+		return maze.findPathToNearest( position , passages , path , target );
+	}
+
+
+
+	bool ExplorationPolicy::keepPassage( const Maze& /*maze*/ , PositionVector /*position*/ ,
+		const Maze::Path& /*route*/ , const NodePair& /*target*/ )
+	{
+		return true;
+	}
+
+
+
+	void FrontierPolicy::setRevealWeight( float weight )
+	{
+		revealWeight = weight;
+	}
+
+
+
+	void FrontierPolicy::setBlockedWeight( float weight )
+	{
+		blockedWeight = weight;
+	}
+
+
+
+	void FrontierPolicy::setWallChance( float chance )
+	{
+		wallChance = chance;
+	}
+
+
+
+	bool FrontierPolicy::selectPassage( Maze& maze , PositionVector position , const Maze::Path& route ,
+		const NodePairList& passages , Maze::Path& path , NodePair& target )
+	{
+		// the passages are only known by their ends, so find their nodes on the route
+		// before 'path' is written, it may be the same path
+		setRoute( route );
+
+		path.clear();
+
+		// the moves to both ends of every passage, from one search
+		maze.findDistances( position , passages );
+
+		bool found = false;
+		float bestScore = 0.0f;
+
+		for ( unsigned int p = 0; p < passages.size(); p++ )
+		{
+			int firstIndex = Maze::Geometry::getIndex( passages[ p ].first.x() , passages[ p ].first.y() );
+			int lastIndex = Maze::Geometry::getIndex( passages[ p ].second.x() , passages[ p ].second.y() );
+			int first = 0;
+
+			while ( first < numNodes && nodes[ first ] != firstIndex )
+			{
+				first++;
+			}
+
+			int last = first;
+
+			while ( last < numNodes && nodes[ last ] != lastIndex )
+			{
+				last++;
+			}
+
+			if ( last >= numNodes )
+			{
+				continue; // not a passage of this route
+			}
+
+			// the mouse can go through the passage from either end, like findPathToNearest
+			for ( int reverse = 0; reverse < 2; reverse++ )
+			{
+				NodePair passage = reverse ? std::make_pair( passages[ p ].second , passages[ p ].first ) : passages[ p ];
+				int travel = maze.getFoundDistance( passage.first );
+
+				if ( travel < 0 )
+				{
+					continue; // the entry cannot be reached over explored nodes
+				}
+
+				float score = scorePassage( maze , first , last , travel );
+
+				if ( !found || score < bestScore )
+				{
+					found = true;
+					bestScore = score;
+					target = passage;
+				}
+			}
+		}
+
+		return found && maze.findPath( position , target.first , path );
+	}
+
+
+
+	bool FrontierPolicy::keepPassage( const Maze& /*maze*/ , PositionVector /*position*/ ,
+		const Maze::Path& route , const NodePair& target )
+	{
+		setRoute( route );
+
+		int exitIndex = Maze::Geometry::getIndex( target.second.x() , target.second.y() );
+
+		for ( int i = 0; i < numNodes; i++ )
+		{
+			if ( nodes[ i ] == exitIndex )
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+
+
+	void FrontierPolicy::setRoute( const Maze::Path& route )
+	{
+		int x = PositionVector::START.x();
+		int y = PositionVector::START.y();
+
+		numNodes = 0;
+		nodes[ numNodes++ ] = Maze::Geometry::getIndex( x , y );
+
+		for ( int i = 0; i < route.size(); i++ )
+		{
+			DirectionVector step = route.getStep( i );
+
+			for ( int j = 0; j < step.mag(); j++ )
+			{
+				x += Maze::Geometry::DX[ step.dir() ];
+				y += Maze::Geometry::DY[ step.dir() ];
+				nodes[ numNodes++ ] = Maze::Geometry::getIndex( x , y );
+			}
+		}
+	}
+
+
+
+	float FrontierPolicy::scorePassage( const Maze& maze , int first , int last , int travel )
+	{
+		seen.clear();
+
+		int revealed = 0;
+		int unknownEdges = 0;
+
+		for ( int i = first + 1; i < last; i++ )
+		{
+			PositionVector pos = getPos( nodes[ i ] );
+
+			// an edge node is between two cells and may be a wall
+			if ( !maze.isExplored( pos ) && ( pos.x() + pos.y() ) % 2 != 0 )
+			{
+				unknownEdges++;
+			}
+
+			// lookAround sees the node itself and its neighbors
+			for ( int d = 0; d < 5; d++ )
+			{
+				PositionVector near = d < 4 ? pos + lookDirections[ d ] : pos;
+
+				if ( maze.hasNode( near ) && !maze.isExplored( near ) && !seen.get( near.x() , near.y() ) )
+				{
+					seen.set( near.x() , near.y() , true );
+					revealed++;
+				}
+			}
+		}
+
+		float blockedChance = 1.0f - powf( 1.0f - wallChance , static_cast< float >( unknownEdges ) );
+
+		return travel + ( last - first ) - revealWeight * revealed - blockedWeight * blockedChance;
+	}
+
+
+
+	PositionVector FrontierPolicy::getPos( int index )
+	{
+		return PositionVector( index / Maze::NUM_NODES_H , index % Maze::NUM_NODES_H );
+	}
+}
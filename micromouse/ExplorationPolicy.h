@@ -0,0 +1,104 @@
+#pragma once
+#include "Vector.h"
+#include "Maze.h"
+
+
+
+namespace Micromouse
+{
+	// Chooses where MouseBot::mapMaze explores next.
+	//
+	// Every time the mapping path from START to FINISH still crosses unexplored nodes, mapMaze
+	// collects the passages where it does, each an explored node before the unexplored nodes and the
+	// explored node after them. The policy picks the passage to explore and the path over explored
+	// nodes to its entry, the mouse then drives through the passage toward the exit. After every path
+	// it drives the mapping path is found again, and the policy can keep the passage or choose again.
+	// Mapping ends once no passage is left, whatever the policy picks.
+	class ExplorationPolicy
+	{
+	public:
+		virtual ~ExplorationPolicy() {}
+
+		// chooses the passage of 'passages' to explore next for the mouse at 'position' in 'maze',
+		// 'route' is the mapping path from START to FINISH the passages were found on
+		// writes the path over explored nodes to the first node of the passage into 'path', sets 'target'
+		// to the passage and returns true, or returns false and leaves 'path' empty if none can be reached
+		// 'path' may be the same path as 'route'
+		virtual bool selectPassage( Maze& maze , PositionVector position , const Maze::Path& route ,
+			const NodePairList& passages , Maze::Path& path , NodePair& target ) = 0;
+
+		// returns true if the mouse at 'position' should keep driving to the exit of 'target' now that the
+		// mapping path from START to FINISH is 'route', or false to choose a passage again
+		// keeps every passage until its exit is reached by default
+		virtual bool keepPassage( const Maze& maze , PositionVector position , const Maze::Path& route ,
+			const NodePair& target );
+	};
+
+
+
+	// The passage with the nearest entry, found by one Maze::findPathToNearest search.
+	// This is what mapMaze does when no policy is set.
+	class NearestPassagePolicy : public ExplorationPolicy
+	{
+	public:
+		bool selectPassage( Maze& maze , PositionVector position , const Maze::Path& route ,
+			const NodePairList& passages , Maze::Path& path , NodePair& target );
+	};
+
+
+
+	// Scores every passage by the moves it costs and picks the lowest score. It drops a passage once
+	// the mapping path no longer goes through its exit, since a wall found on the way moved the path
+	// and the rest of the passage may not matter any more.
+	//
+	// The mouse can enter a passage by either end. The cost is the moves to that end over explored
+	// nodes, found for every end by one Maze::findDistances search, plus the nodes through the passage.
+	//
+	// The score can also count what exploring the passage is worth against its cost: the unexplored
+	// nodes the mouse sees on the way, the passage nodes and their neighbors, and the chance that the
+	// passage is blocked, which changes the route and makes driving to the other passages unnecessary.
+	// Each unexplored edge node of the passage is guessed to be a wall with the same chance, so a longer
+	// passage is more likely to be blocked.
+	// The weights of what a passage is worth, setRevealWeight and setBlockedWeight, are both 0 by default,
+	// so by default a passage is only scored by the moves it costs.
+	class FrontierPolicy : public ExplorationPolicy
+	{
+	public:
+		// the moves one unexplored node seen is worth, 0 by default
+		void setRevealWeight( float weight );
+
+		// the moves a blocked passage is worth, 0 by default
+		void setBlockedWeight( float weight );
+
+		// the chance that an unexplored edge node is a wall, 0.5 by default
+		void setWallChance( float chance );
+
+		bool selectPassage( Maze& maze , PositionVector position , const Maze::Path& route ,
+			const NodePairList& passages , Maze::Path& path , NodePair& target );
+
+		bool keepPassage( const Maze& maze , PositionVector position , const Maze::Path& route ,
+			const NodePair& target );
+
+	private:
+		// fills 'nodes' with the nodes of 'route' from START
+		void setRoute( const Maze::Path& route );
+
+		// returns the score of the passage from nodes[ first ] to nodes[ last ] of the route,
+		// for the mouse 'travel' moves from the end it enters by, lower is better
+		float scorePassage( const Maze& maze , int first , int last , int travel );
+
+		// returns the position of the node at 'index'
+		static PositionVector getPos( int index );
+
+		float revealWeight = 0.0f;
+		float blockedWeight = 0.0f;
+		float wallChance = 0.5f;
+
+		// the indices of the nodes of the route from START
+		unsigned short nodes[ Maze::Path::MAX_STEPS + 1 ];
+		int numNodes = 0;
+
+		// the unexplored nodes already counted for the passage being scored
+		BitBoard seen;
+	};
+}
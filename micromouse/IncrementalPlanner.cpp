@@ -0,0 +1,287 @@
+#include "IncrementalPlanner.h"
+#include "Maze.h"
+#include <stdlib.h>
+#include <limits.h>
+#include <assert.h>
+
+
+
+
+namespace Micromouse
+{
+	// only straight moves are possible while mapping
+	static const direction plannerDirections[] = { N , E , S , W };
+	static const int NUM_PLANNER_DIRECTIONS = 4;
+
+	// a key is compared first by its estimated total cost, then by its cost from start
+	// every cost is below the scale so the two can be packed into one int for the NodeHeap,
+	// the planner only makes straight moves so a path costs at most STRAIGHT_COST per node
+	template < int WIDTH , int HEIGHT >
+	struct PlannerKey
+	{
+		typedef MazeGeometry< WIDTH , HEIGHT > Geometry;
+
+		static const int KEY_SCALE = STRAIGHT_COST * Geometry::NUM_NODES + 1;
+		static const int MAX_ESTIMATE = STRAIGHT_COST * ( Geometry::NUM_NODES_W + Geometry::NUM_NODES_H );
+		static_assert( KEY_SCALE + MAX_ESTIMATE + 1 < INT_MAX / KEY_SCALE , "every key must fit in an int below INT_MAX" );
+	};
+
+
+
+	template < int WIDTH , int HEIGHT >
+	IncrementalPlannerT< WIDTH , HEIGHT >::IncrementalPlannerT( const MazeT< WIDTH , HEIGHT >& maze , PositionVector start , PositionVector goal ) :
+		maze( maze ),
+		start( start ),
+		goal( goal ),
+		openList( Geometry::NUM_NODES )
+	{
+		g = new unsigned short[ Geometry::NUM_NODES ];
+		rhs = new unsigned short[ Geometry::NUM_NODES ];
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	IncrementalPlannerT< WIDTH , HEIGHT >::~IncrementalPlannerT()
+	{
+		delete[] g;
+		delete[] rhs;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	PositionVector IncrementalPlannerT< WIDTH , HEIGHT >::getStart() const
+	{
+		return start;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	PositionVector IncrementalPlannerT< WIDTH , HEIGHT >::getGoal() const
+	{
+		return goal;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	bool IncrementalPlannerT< WIDTH , HEIGHT >::findPath( unsigned long& nodesExpanded )
+	{
+		if ( !initialized )
+		{
+			for ( int i = 0; i < Geometry::NUM_NODES; i++ )
+			{
+				g[ i ] = INF;
+				rhs[ i ] = INF;
+			}
+
+			openList.clear();
+
+			rhs[ getIndex( start ) ] = 0;
+			openList.push( getIndex( start ) , calculateKey( getIndex( start ) ) );
+
+			initialized = true;
+		}
+
+		computeShortestPath( nodesExpanded );
+
+		return g[ getIndex( goal ) ] != INF;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	direction IncrementalPlannerT< WIDTH , HEIGHT >::getPathDirection( PositionVector pos ) const
+	{
+		direction bestDir = NONE;
+		int bestCost = INF;
+
+		// the best path comes from the neighbor with the lowest cost through it
+		for ( int d = 0; d < NUM_PLANNER_DIRECTIONS; d++ )
+		{
+			int neighbor = maze.getNeighborIndex( getIndex( pos ) , plannerDirections[ d ] );
+
+			if ( neighbor == MazeT< WIDTH , HEIGHT >::NO_NODE )
+			{
+				continue;
+			}
+
+			int cost = g[ neighbor ] + STRAIGHT_COST;
+
+			if ( cost < bestCost )
+			{
+				// the path moves from the neighbor to 'pos'
+				bestDir = plannerDirections[ d ] + S;
+				bestCost = cost;
+			}
+		}
+
+		assert( bestDir != NONE );
+
+		return bestDir;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	void IncrementalPlannerT< WIDTH , HEIGHT >::updateNode( PositionVector pos )
+	{
+		// the costs are built from scratch on the first findPath
+		if ( !initialized )
+		{
+			return;
+		}
+
+		int index = getIndex( pos );
+
+		if ( !maze.hasNode( pos ) )
+		{
+			// a removed node can not be reached
+			g[ index ] = INF;
+			rhs[ index ] = INF;
+			openList.remove( index );
+		}
+		else
+		{
+			updateVertex( index );
+		}
+
+		// the node was a possible parent of each of its neighbors
+		for ( int d = 0; d < NUM_PLANNER_DIRECTIONS; d++ )
+		{
+			int neighbor = maze.getNeighborIndex( index , plannerDirections[ d ] );
+
+			if ( neighbor != MazeT< WIDTH , HEIGHT >::NO_NODE )
+			{
+				updateVertex( neighbor );
+			}
+		}
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	void IncrementalPlannerT< WIDTH , HEIGHT >::reset()
+	{
+		initialized = false;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	void IncrementalPlannerT< WIDTH , HEIGHT >::updateVertex( int index )
+	{
+		if ( index != getIndex( start ) )
+		{
+			int best = INF;
+
+			for ( int d = 0; d < NUM_PLANNER_DIRECTIONS; d++ )
+			{
+				int neighbor = maze.getNeighborIndex( index , plannerDirections[ d ] );
+
+				if ( neighbor == MazeT< WIDTH , HEIGHT >::NO_NODE )
+				{
+					continue;
+				}
+
+				int neighborG = g[ neighbor ];
+
+				if ( neighborG != INF && neighborG + STRAIGHT_COST < best )
+				{
+					best = neighborG + STRAIGHT_COST;
+				}
+			}
+
+			rhs[ index ] = best;
+		}
+
+		// only inconsistent nodes belong on the open list
+		if ( g[ index ] != rhs[ index ] )
+		{
+			openList.push( index , calculateKey( index ) );
+		}
+		else
+		{
+			openList.remove( index );
+		}
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	void IncrementalPlannerT< WIDTH , HEIGHT >::computeShortestPath( unsigned long& nodesExpanded )
+	{
+		int goalIndex = getIndex( goal );
+
+		while ( !openList.empty() && ( openList.topKey() < calculateKey( goalIndex ) || rhs[ goalIndex ] != g[ goalIndex ] ) )
+		{
+			int index = openList.pop();
+			nodesExpanded++;
+
+			if ( g[ index ] > rhs[ index ] )
+			{
+				// the node got cheaper, settle it
+				g[ index ] = rhs[ index ];
+			}
+			else
+			{
+				// the node got more expensive, reopen it and let its neighbors find new parents
+				g[ index ] = INF;
+				updateVertex( index );
+			}
+
+			for ( int d = 0; d < NUM_PLANNER_DIRECTIONS; d++ )
+			{
+				int neighbor = maze.getNeighborIndex( index , plannerDirections[ d ] );
+
+				if ( neighbor != MazeT< WIDTH , HEIGHT >::NO_NODE )
+				{
+					updateVertex( neighbor );
+				}
+			}
+		}
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	int IncrementalPlannerT< WIDTH , HEIGHT >::calculateKey( int index ) const
+	{
+		int cost = g[ index ] < rhs[ index ] ? g[ index ] : rhs[ index ];
+
+		if ( cost == INF )
+		{
+			return INT_MAX; // after every reachable node
+		}
+
+		return ( cost + estimateCost( index ) ) * PlannerKey< WIDTH , HEIGHT >::KEY_SCALE + cost;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	int IncrementalPlannerT< WIDTH , HEIGHT >::estimateCost( int index ) const
+	{
+		return STRAIGHT_COST * ( abs( index / Geometry::NUM_NODES_H - goal.x() ) + abs( index % Geometry::NUM_NODES_H - goal.y() ) );
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	int IncrementalPlannerT< WIDTH , HEIGHT >::getIndex( PositionVector pos ) const
+	{
+		return Geometry::getIndex( pos.x() , pos.y() );
+	}
+
+
+
+	// the classic and the half size competition mazes, only the simulator builds the half size one
+	template class IncrementalPlannerT< 16 , 16 >;
+
+#ifdef __MK20DX256__ // Teensy Compile
+#else // PC compile
+	template class IncrementalPlannerT< 32 , 32 >;
+#endif
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include "Vector.h"
+#include "NodeListener.h"
+#include "NodeHeap.h"
+#include "MazeGeometry.h"
+
+
+
+namespace Micromouse
+{
+	template < int WIDTH , int HEIGHT > class MazeT;
+
+	// An incremental planner (Lifelong Planning A*) for one fixed pair of start and goal nodes.
+	// During mapping the same START to FINISH query is asked after every step, while each
+	// step only removes a few nodes. The planner keeps its costs between queries and only
+	// repairs the part of the search that was affected by the nodes that changed.
+	//
+	// Unexplored nodes are treated as open, like Maze::findPath does while mapping.
+	// The maze calls updateNode() whenever a node is added or removed, see NodeListener.
+	template < int WIDTH , int HEIGHT >
+	class IncrementalPlannerT : public NodeListener
+	{
+	public:
+		typedef MazeGeometry< WIDTH , HEIGHT > Geometry;
+
+		IncrementalPlannerT( const MazeT< WIDTH , HEIGHT >& maze , PositionVector start , PositionVector goal );
+		~IncrementalPlannerT();
+
+		// a copy would free the arrays it owns twice
+		IncrementalPlannerT( const IncrementalPlannerT& ) = delete;
+		IncrementalPlannerT& operator=( const IncrementalPlannerT& ) = delete;
+
+		PositionVector getStart() const;
+		PositionVector getGoal() const;
+
+		// brings the search up to date
+		// returns true if there is a path from start to goal
+		// 'nodesExpanded' is increased by the number of nodes expanded
+		bool findPath( unsigned long& nodesExpanded );
+
+		// returns the direction of the last move of the shortest path to 'pos'
+		// only valid for the nodes on the path after findPath returned true
+		direction getPathDirection( PositionVector pos ) const;
+
+		// must be called after the node at 'pos' was added or removed from the maze
+		void updateNode( PositionVector pos );
+
+		// forgets every cost, the next findPath will search from scratch
+		void reset();
+
+	private:
+		// recalculates the lowest cost to reach 'index' through its neighbors
+		// and puts it on the open list if it is inconsistent
+		void updateVertex( int index );
+
+		// expands nodes until the goal's cost is correct
+		void computeShortestPath( unsigned long& nodesExpanded );
+
+		// returns the priority of 'index' on the open list
+		int calculateKey( int index ) const;
+
+		// returns the estimated cost from 'index' to the goal
+		int estimateCost( int index ) const;
+
+		int getIndex( PositionVector pos ) const;
+
+		const MazeT< WIDTH , HEIGHT >& maze;
+
+		PositionVector start;
+		PositionVector goal;
+
+		bool initialized = false;
+
+		unsigned short* g; // g[ index ] is the cost of the best path found from start
+		unsigned short* rhs; // rhs[ index ] is the cost through the best neighbor, one step ahead of g
+
+		NodeHeap openList;
+	};
+
+	// the planner for the maze size the mouse is built for
+	typedef IncrementalPlannerT< MAZE_W , MAZE_H > IncrementalPlanner;
+}
@@ -1,243 +1,1567 @@
 #include <vector>
 #include <algorithm>
 #include <math.h>
+#include <stdlib.h>
 #include "Maze.h"
+#include "Timer.h"
 #include <assert.h>
 
 namespace Micromouse
 {
 	// constructors //////////////////////////////////////////////////
 
-	Maze::Maze()
+	template < int WIDTH , int HEIGHT >
+	MazeT< WIDTH , HEIGHT >::MazeT() :
+		openHeap( NUM_NODES ),
+		incrementalPlanner( *this , PositionVector::START , getFinish() ),
+		corridorGraph( *this , openHeap ),
+		exploredPruner( nodeExplored ),
+		presentPruner( nodePresent )
 	{
 		initNodes();
+
+		// the mapping planner and the present nodes' pruner do not depend on the explored flags
+		addListener( &incrementalPlanner , false );
+		addListener( &corridorGraph , true );
+		addListener( &exploredPruner , true );
+		addListener( &presentPruner , false );
+
+		// the LOWER_BOUND tables are only allocated once they are used
+		for ( int i = 0; i < NUM_LOWER_BOUND_TABLES; i++ )
+		{
+			lowerBoundTables[ i ] = nullptr;
+			lowerBoundEnds[ i ] = -1;
+		}
 	}
 
 
 
-	Maze::~Maze()
+	template < int WIDTH , int HEIGHT >
+	MazeT< WIDTH , HEIGHT >::~MazeT()
 	{
+		for ( int i = 0; i < NUM_LOWER_BOUND_TABLES; i++ )
+		{
+			delete[] lowerBoundTables[ i ];
+		}
+
+		delete openBuckets;
+		delete runPlanner;
+		delete distanceTable;
+		delete floodFill;
+		delete anytimePlanner;
 	}
 
 
 
-	// this is to allow the sorting of the vector of Nodes
-	// sorts in descending order
-	bool nodeComparator( const Node* lhs , const Node* rhs )
+	// this is to allow the sorting of the vector of node indices
+	// sorts in descending order of F
+	struct NodeComparator
 	{
-		return lhs->getF() > rhs->getF();
-	}
+		const unsigned short* F;
 
+		bool operator()( int lhs , int rhs ) const
+		{
+			return F[ lhs ] > F[ rhs ];
+		}
+	};
 
 
-	Path * Maze::findPath( PositionVector start , PositionVector end , bool isMapping , NodePairList* passageNodes)
+
+	// returns the cost of moving one node in the direction 'dir'
+	// if moved diagnal 14, else moved straight 10
+	int getMoveCost( direction dir )
 	{
-		resetNodes();
+		return ( dir == direction::NW || dir == direction::SW || dir == direction::NE || dir == direction::SE ) ? DIAGONAL_COST : STRAIGHT_COST;
+	}
+
 
+
+	template < int WIDTH , int HEIGHT >
+	bool MazeT< WIDTH , HEIGHT >::findPath( PositionVector start , PositionVector end , Path& path , bool isMapping , NodePairList* passageNodes)
+	{
 		// if pathfinding during mapping
 		if (passageNodes != nullptr)
 		{
 			// Assert that both start and end have been explored
 			// This is needed to guarantee that NodePairs will be complete
-			assert(getNode(start)->isExplored() && getNode(end)->isExplored());
+			assert(isExplored(start) && isExplored(end));
+
+			// a NodePairList should on be used during mapping
+			assert(isMapping);
+		}
+
+		int query = isMapping ? MAPPING_QUERY : EXPLORED_QUERY;
+
+		// the NodePairList is only made by a search
+		if ( passageNodes == nullptr )
+		{
+			CachedPath* cached = findCachedPath( start , end , query );
+
+			if ( cached != nullptr )
+			{
+				path = cached->path;
+				return cached->found;
+			}
+		}
+
+		unsigned long nodesExpanded = searchStats.nodesExpanded;
+
+		int endNode;
+
+		// the planners stand in for the default engine, any other engine answers every query itself
+		bool usePlanners = searchEngine == BINARY_HEAP;
+
+		if ( usePlanners && incrementalPlanning && isMapping && start == incrementalPlanner.getStart() && end == incrementalPlanner.getGoal() )
+		{
+			endNode = searchIncremental();
+		}
+		else if ( usePlanners && corridorContraction && !isMapping && isExplored( start ) )
+		{
+			resetNodes();
+
+			Board ends;
+			ends.set( end.x() , end.y() , true );
+			endNode = corridorGraph.findPath( start , ends , searchStats.nodesExpanded , getSkippedNodes( start , end , false ) );
+		}
+		else
+		{
+			resetNodes();
+
+			searchEndX = end.x();
+			searchEndY = end.y();
+			searchLowerBounds = heuristic == LOWER_BOUND ? getLowerBounds( end ) : nullptr;
+
+			switch ( searchEngine )
+			{
+			case SORTED_LIST:
+				endNode = searchSortedList( start , end , isMapping );
+				break;
+
+			case BUCKET_QUEUE:
+				if ( openBuckets == nullptr )
+				{
+					// keys are F values, which never grow by more than 2 move costs from the node being expanded
+					openBuckets = new BucketQueue( NUM_NODES , 2 * DIAGONAL_COST + 1 );
+				}
+
+				endNode = searchOpenList( *openBuckets , start , end , isMapping );
+				break;
+
+			case FLOOD_FILL:
+			{
+				Board ends;
+				ends.set( end.x() , end.y() , true );
+				endNode = searchFloodFill( start , ends , isMapping );
+				break;
+			}
+
+			case BIDIRECTIONAL:
+				endNode = searchBidirectional( start , end , isMapping );
+				break;
+
+			case JUMP_POINT:
+				endNode = searchJumpPoint( start , end , isMapping );
+				break;
+
+			case BINARY_HEAP:
+			default:
+				endNode = searchOpenList( openHeap , start , end , isMapping );
+				break;
+			}
+		}
+
+		recordSearch( nodesExpanded );
+
+		path.clear();
+
+		// no path was found
+		// this should never happen in real maze
+		// TODO throw error if this is reached in real testing
+		bool found = endNode != NO_NODE;
+
+		if ( found )
+		{
+			// fill in the path for motion control to utilize
+			createPath( endNode , path , isMapping , passageNodes );
+		}
+
+		if ( passageNodes == nullptr )
+		{
+			cachePath( start , end , query , found , path );
+		}
+
+		return found;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	bool MazeT< WIDTH , HEIGHT >::findRunPath( PositionVector start , direction facing , PositionVector end , Path& path )
+	{
+		int query = RUN_QUERY + facing;
+		CachedPath* cached = findCachedPath( start , end , query );
+
+		if ( cached != nullptr )
+		{
+			path = cached->path;
+			runPathTime = cached->runTime;
+			return cached->found;
+		}
+
+		if ( runPlanner == nullptr )
+		{
+			runPlanner = new RunPlannerT< WIDTH , HEIGHT >( *this , openHeap );
+		}
+
+		unsigned long nodesExpanded = searchStats.nodesExpanded;
+
+		bool found = runPlanner->findPath( start , facing , end , motionModel , path , searchStats.nodesExpanded , getSkippedNodes( start , end , true ) );
+
+		recordSearch( nodesExpanded );
+
+		runPathTime = runPlanner->getPathTime();
+		cachePath( start , end , query , found , path , runPathTime );
+
+		return found;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	float MazeT< WIDTH , HEIGHT >::getRunPathTime() const
+	{
+		return runPathTime;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	typename MazeT< WIDTH , HEIGHT >::CachedPath* MazeT< WIDTH , HEIGHT >::findCachedPath( PositionVector start , PositionVector end , int query )
+	{
+		for ( int i = 0; i < NUM_CACHED_PATHS; i++ )
+		{
+			CachedPath& cached = cachedPaths[ i ];
+
+			if ( cached.revision == revision && cached.query == query && cached.start == getIndex( start ) && cached.end == getIndex( end ) )
+			{
+				cached.lastUsed = ++cacheClock;
+				searchStats.cacheHits++;
+				return &cached;
+			}
+		}
+
+		return nullptr;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	void MazeT< WIDTH , HEIGHT >::cachePath( PositionVector start , PositionVector end , int query , bool found , const Path& path , float runTime )
+	{
+		// replace an entry from an earlier revision, or else the one used longest ago
+		CachedPath* oldest = &cachedPaths[ 0 ];
+
+		for ( int i = 0; i < NUM_CACHED_PATHS; i++ )
+		{
+			CachedPath& cached = cachedPaths[ i ];
+
+			if ( cached.revision != revision )
+			{
+				oldest = &cached;
+				break;
+			}
+
+			if ( cached.lastUsed < oldest->lastUsed )
+			{
+				oldest = &cached;
+			}
+		}
+
+		oldest->revision = revision;
+		oldest->lastUsed = ++cacheClock;
+		oldest->start = getIndex( start );
+		oldest->end = getIndex( end );
+		oldest->query = query;
+		oldest->found = found;
+		oldest->runTime = runTime;
+		oldest->path = path;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	void MazeT< WIDTH , HEIGHT >::setFloodGoal( PositionVector goal )
+	{
+		if ( floodFill == nullptr )
+		{
+			floodFill = new ModifiedFloodFillT< WIDTH , HEIGHT >( *this );
+			addListener( floodFill , false );
+		}
+
+		unsigned long nodesExpanded = searchStats.nodesExpanded;
+
+		floodFill->setGoal( goal , searchStats.nodesExpanded );
+
+		recordSearch( nodesExpanded );
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	direction MazeT< WIDTH , HEIGHT >::getFloodDirection( PositionVector pos , direction facing )
+	{
+		assert( floodFill != nullptr && floodFill->hasGoal() );
+
+		unsigned long nodesExpanded = searchStats.nodesExpanded;
+
+		floodFill->update( searchStats.nodesExpanded );
+
+		recordSearch( nodesExpanded );
+
+		return floodFill->getDirection( pos , facing );
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	int MazeT< WIDTH , HEIGHT >::getFloodDistance( PositionVector pos )
+	{
+		if ( floodFill == nullptr )
+		{
+			return -1;
+		}
+
+		unsigned long nodesExpanded = searchStats.nodesExpanded;
+
+		floodFill->update( searchStats.nodesExpanded );
+
+		recordSearch( nodesExpanded );
+
+		return floodFill->getDistance( pos );
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	void MazeT< WIDTH , HEIGHT >::startAnytimeSearch( PositionVector start , PositionVector end , bool isMapping )
+	{
+		if ( anytimePlanner == nullptr )
+		{
+			anytimePlanner = new AnytimePlannerT< WIDTH , HEIGHT >( *this );
+			addListener( anytimePlanner , false );
+		}
+
+		anytimePlanner->start( start , end , isMapping );
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	bool MazeT< WIDTH , HEIGHT >::advanceAnytimeSearch()
+	{
+		assert( anytimePlanner != nullptr );
+
+		unsigned long nodesExpanded = searchStats.nodesExpanded;
+
+		Timer timer;
+		bool done = anytimePlanner->advance( anytimeSliceExpansions , anytimeSliceMicros , searchStats.nodesExpanded );
+		unsigned long micros = static_cast< unsigned long >( timer.getDeltaTime() * 1000000.0f );
+
+		recordSearch( nodesExpanded );
+
+		searchStats.slices++;
+
+		if ( micros > searchStats.maxSliceMicros )
+		{
+			searchStats.maxSliceMicros = micros;
+		}
+
+		return done;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	bool MazeT< WIDTH , HEIGHT >::getAnytimePath( Path& path ) const
+	{
+		if ( anytimePlanner == nullptr )
+		{
+			path.clear();
+			return false;
+		}
+
+		return anytimePlanner->getPath( path );
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	void MazeT< WIDTH , HEIGHT >::findDistances( PositionVector start , const NodePairList& targets )
+	{
+		unsigned long nodesExpanded = searchStats.nodesExpanded;
+
+		resetNodes();
+
+		Board open = nodePresent;
+		open.andWith( nodeExplored );
+
+		Board missing; // the ends not reached yet
+
+		for ( NodePairList::const_iterator itr = targets.begin(); itr != targets.end(); ++itr )
+		{
+			missing.set( itr->first.x() , itr->first.y() , true );
+			missing.set( itr->second.x() , itr->second.y() , true );
+		}
+
+		Board frontier;
+		Board visited;
+		Board next;
+
+		// like getDistance, nothing is reached from a start that is not explored
+		if ( isExplored( start ) )
+		{
+			frontier.set( start.x() , start.y() , true );
+			visited.set( start.x() , start.y() , true );
+		}
+
+		int cost = 0;
+
+		while ( frontier.any() )
+		{
+			recordWavefront( frontier , nodeG , cost );
+
+			missing.andNot( frontier );
+
+			if ( !missing.any() )
+			{
+				break;
+			}
+
+			next.expand( frontier , open , visited );
+			visited.orWith( next );
+			frontier = next;
+
+			cost += STRAIGHT_COST;
+		}
+
+		recordSearch( nodesExpanded );
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	int MazeT< WIDTH , HEIGHT >::getFoundDistance( PositionVector pos ) const
+	{
+		if ( !hasNode( pos ) )
+		{
+			return -1;
+		}
+
+		// only the nodes the wavefront reached were written by the search
+		int index = getIndex( pos );
+
+		return nodeStamp[ index ] == searchEpoch ? nodeG[ index ] / STRAIGHT_COST : -1;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	bool MazeT< WIDTH , HEIGHT >::findPathToNearest( PositionVector start , const NodePairList& targets , Path& path , NodePair& nearest )
+	{
+		unsigned long nodesExpanded = searchStats.nodesExpanded;
+
+		resetNodes();
+
+		Board ends;
+
+		for ( NodePairList::const_iterator itr = targets.begin(); itr != targets.end(); ++itr )
+		{
+			ends.set( itr->first.x() , itr->first.y() , true );
+			ends.set( itr->second.x() , itr->second.y() , true );
+		}
+
+		int endNode;
+
+		if ( searchEngine == BINARY_HEAP && corridorContraction && isExplored( start ) )
+		{
+			// the targets are at the edge of the explored maze, often in a dead end, so none are skipped
+			endNode = corridorGraph.findPath( start , ends , searchStats.nodesExpanded , nullptr );
+		}
+		else
+		{
+			// every move is straight, so the first target the wavefront reaches is the nearest
+			endNode = searchFloodFill( start , ends , false );
+		}
+
+		recordSearch( nodesExpanded );
+
+		path.clear();
+
+		if ( endNode == NO_NODE )
+		{
+			return false;
+		}
+
+		createPath( endNode , path );
+
+		// the pair with the end that was reached, that end comes first
+		PositionVector end = getPos( endNode );
+
+		for ( NodePairList::const_iterator itr = targets.begin(); itr != targets.end(); ++itr )
+		{
+			if ( end == itr->first || end == itr->second )
+			{
+				nearest = end == itr->first ? *itr : NodePair( itr->second , itr->first );
+				break;
+			}
+		}
+
+		return true;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	int MazeT< WIDTH , HEIGHT >::searchSortedList( PositionVector start , PositionVector end , bool isMapping )
+	{
+		std::vector< int >& openNodes = sortedOpenList;
+		NodeComparator nodeComparator = { nodeF };
+
+		// assume 1/2 of the maze will need to be searched on average;
+		// this prevents too many resizes, idk if this is optimal I was just estimating
+		// the list is kept between searches so this only allocates on the first search
+		openNodes.clear();
+		openNodes.reserve( static_cast< int >( NUM_NODES * 0.5f ) );
+
+		// the start node is added to openNodes
+		openNodes.push_back( getIndex( start ) );
+
+		// initialize the movement cost to 0 for the first node
+		touchNode( getIndex( start ) );
+		nodeG[ getIndex( start ) ] = 0;
+
+		int endNode = getIndex( end );
+		int currentNode;
+		int neighborNode;
+		int tentative_G;
+
+		// While there are still open nodes remaining
+		while ( !openNodes.empty() )
+		{
+			// sort the nodes in descending order by F value
+			// we sort by descending so we can later us pop_back()
+			std::sort( openNodes.begin() , openNodes.end() , nodeComparator ); 
+
+			// get the node with the lowest F value
+			currentNode = openNodes.back();
+			searchStats.nodesExpanded++;
+
+			// if we are at the end node then we are done!
+			if ( currentNode == endNode ) 
+			{
+				return currentNode;
+			}
+
+			openNodes.pop_back();
+			setFlag( nodeClosed , currentNode , true );
+
+			// loop through neighbor nodes
+			for ( direction dir = N; dir != NONE; ++dir )
+			{
+				neighborNode = getNeighborIndex( currentNode , dir );
+
+				if ( neighborNode == NO_NODE )
+				{
+					continue; // there is no neighbor node in this direction
+				}
+
+				touchNode( neighborNode );
+
+				if ( getFlag( nodeClosed , neighborNode ) )
+				{
+					continue; // Ignore the neighbor which is already evaluated
+				}
+
+				if ( !isMapping && !nodeExplored.get( neighborNode / NUM_NODES_H , neighborNode % NUM_NODES_H ) )
+				{
+					continue; // Ignore the unexplored nodes if we arent mapping
+				}
+
+
+				tentative_G = nodeG[ currentNode ] + getMoveCost( dir );
+
+
+				//if neighborNode is not already in openNodes then add id
+				if ( std::find( openNodes.begin() , openNodes.end() , neighborNode ) == openNodes.end() )
+				{
+					openNodes.push_back( neighborNode );
+				}
+				// else the neighborNode is already in openNodes
+				// if new path to neighborNode is worse than previous
+				else if ( tentative_G >= nodeG[ neighborNode ] )
+				{
+					continue; //this is not a better path
+				}
+
+				//if we made it to this point then
+				//this path is the best so far
+				nodeParent[ neighborNode ] = currentNode;
+				nodeDir[ neighborNode ] = dir;
+				nodeG[ neighborNode ] = tentative_G;
+				nodeF[ neighborNode ] = tentative_G + estimateCost( neighborNode );
+			}
+		}
+
+		return NO_NODE;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	template < class OpenList >
+	int MazeT< WIDTH , HEIGHT >::searchOpenList( OpenList& openList , PositionVector start , PositionVector end , bool isMapping )
+	{
+		int endNode = getIndex( end );
+		int startNode = getIndex( start );
+
+		// the open list is emptied here instead of at every return
+		openList.clear();
+
+		// the start node is added to the open list with a movement cost of 0
+		touchNode( startNode );
+		nodeG[ startNode ] = 0;
+		nodeF[ startNode ] = estimateCost( startNode );
+		openList.push( startNode , nodeF[ startNode ] );
+
+		int currentNode;
+		int neighborNode;
+		int tentative_G;
+
+		// While there are still open nodes remaining
+		while ( !openList.empty() )
+		{
+			// get the node with the lowest F value
+			currentNode = openList.pop();
+			searchStats.nodesExpanded++;
+
+			// if we are at the end node then we are done!
+			if ( currentNode == endNode )
+			{
+				return currentNode;
+			}
+
+			setFlag( nodeClosed , currentNode , true );
+
+			// loop through neighbor nodes
+			for ( direction dir = N; dir != NONE; ++dir )
+			{
+				neighborNode = getNeighborIndex( currentNode , dir );
+
+				if ( neighborNode == NO_NODE )
+				{
+					continue; // there is no neighbor node in this direction
+				}
+
+				touchNode( neighborNode );
+
+				if ( getFlag( nodeClosed , neighborNode ) )
+				{
+					continue; // the neighbor was already evaluated
+				}
+
+				if ( !isMapping && !nodeExplored.get( neighborNode / NUM_NODES_H , neighborNode % NUM_NODES_H ) )
+				{
+					continue; // Ignore the unexplored nodes if we arent mapping
+				}
+
+				tentative_G = nodeG[ currentNode ] + getMoveCost( dir );
+
+				// nodes that have not been reached yet have a G of INF
+				// so this also handles adding new nodes to the open list
+				if ( tentative_G >= nodeG[ neighborNode ] )
+				{
+					continue; //this is not a better path
+				}
+
+				nodeParent[ neighborNode ] = currentNode;
+				nodeDir[ neighborNode ] = dir;
+				nodeG[ neighborNode ] = tentative_G;
+				nodeF[ neighborNode ] = tentative_G + estimateCost( neighborNode );
+
+				// adds the node or decreases its key if it is already open
+				openList.push( neighborNode , nodeF[ neighborNode ] );
+			}
+		}
+
+		return NO_NODE;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	int MazeT< WIDTH , HEIGHT >::searchFloodFill( PositionVector start , const Board& ends , bool isMapping )
+	{
+		// the nodes the wavefront may enter
+		Board open = nodePresent;
+
+		if ( !isMapping )
+		{
+			open.andWith( nodeExplored ); // Ignore the unexplored nodes if we arent mapping
+		}
+
+		Board frontier;
+		Board visited;
+		Board next;
+		Board reached; // the end nodes in visited
+
+		frontier.set( start.x() , start.y() , true );
+		visited.set( start.x() , start.y() , true );
+
+		int cost = 0;
+
+		// every node in the wavefront is the same number of moves from start
+		while ( frontier.any() )
+		{
+			recordWavefront( frontier , nodeG , cost );
+
+			// if we reached an end node then we are done!
+			reached = visited;
+			reached.andWith( ends );
+
+			if ( reached.any() )
+			{
+				break;
+			}
+
+			next.expand( frontier , open , visited );
+			visited.orWith( next );
+			frontier = next;
+
+			cost += STRAIGHT_COST;
+		}
+
+		if ( !reached.any() )
+		{
+			return NO_NODE;
+		}
+
+		// the first end node in the last wavefront, they are all the same number of moves from start
+		int endNode = NO_NODE;
+
+		for ( int y = 0; y < NUM_NODES_H && endNode == NO_NODE; y++ )
+		{
+			if ( reached.getRow( y ) != 0 )
+			{
+				endNode = Geometry::getIndex( Board::lowestBit( reached.getRow( y ) ) , y );
+			}
+		}
+
+		traceWavefront( endNode , getIndex( start ) );
+
+		return endNode;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	int MazeT< WIDTH , HEIGHT >::searchBidirectional( PositionVector start , PositionVector end , bool isMapping )
+	{
+		const direction straightDirections[] = { N , E , S , W };
+
+		// the nodes the wavefronts may enter
+		Board open = nodePresent;
+
+		if ( !isMapping )
+		{
+			open.andWith( nodeExplored ); // Ignore the unexplored nodes if we arent mapping
+		}
+
+		// side 0 grows from start and side 1 grows from end
+		Board frontier[ 2 ];
+		Board visited[ 2 ];
+		Board next;
+		Board met; // the nodes both wavefronts reached
+
+		// like the other engines the end must be a node the search may enter, unless it is the start
+		if ( !open.get( end.x() , end.y() ) && !( start == end ) )
+		{
+			return NO_NODE;
+		}
+
+		unsigned short* costs[ 2 ] = { nodeG , nodeF };
+		int cost[ 2 ] = { 0 , 0 };
+		int size[ 2 ];
+
+		frontier[ 0 ].set( start.x() , start.y() , true );
+		frontier[ 1 ].set( end.x() , end.y() , true );
+
+		for ( int side = 0; side < 2; side++ )
+		{
+			visited[ side ] = frontier[ side ];
+			size[ side ] = recordWavefront( frontier[ side ] , costs[ side ] , 0 );
+		}
+
+		met = visited[ 0 ];
+		met.andWith( visited[ 1 ] );
+
+		// a wavefront that runs out of nodes has reached everything it can, so there is no path
+		while ( !met.any() && frontier[ 0 ].any() && frontier[ 1 ].any() )
+		{
+			int side = size[ 0 ] <= size[ 1 ] ? 0 : 1;
+
+			next.expand( frontier[ side ] , open , visited[ side ] );
+			visited[ side ].orWith( next );
+			frontier[ side ] = next;
+
+			cost[ side ] += STRAIGHT_COST;
+			size[ side ] = recordWavefront( frontier[ side ] , costs[ side ] , cost[ side ] );
+
+			// the wavefronts grow one whole step at a time, so the first step that reaches the other
+			// side's nodes makes every node they share the middle of a shortest path
+			met = frontier[ side ];
+			met.andWith( visited[ 1 - side ] );
+		}
+
+		int meetNode = NO_NODE;
+
+		for ( int y = 0; y < NUM_NODES_H && meetNode == NO_NODE; y++ )
+		{
+			if ( met.getRow( y ) != 0 )
+			{
+				meetNode = Geometry::getIndex( Board::lowestBit( met.getRow( y ) ) , y );
+			}
+		}
+
+		if ( meetNode == NO_NODE )
+		{
+			return NO_NODE;
+		}
+
+		traceWavefront( meetNode , getIndex( start ) );
+
+		// walk forward from the meeting node to end, each child is a neighbor with one move less to end
+		int endNode = getIndex( end );
+		int node = meetNode;
+
+		while ( node != endNode )
+		{
+			for ( int d = 0; d < 4; d++ )
+			{
+				int neighborNode = getNeighborIndex( node , straightDirections[ d ] );
+
+				if ( neighborNode != NO_NODE && nodeStamp[ neighborNode ] == searchEpoch && nodeF[ neighborNode ] + STRAIGHT_COST == nodeF[ node ] )
+				{
+					// the path moves from this node on to the neighbor
+					nodeParent[ neighborNode ] = node;
+					nodeDir[ neighborNode ] = straightDirections[ d ];
+					node = neighborNode;
+					break;
+				}
+			}
+		}
+
+		return endNode;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	int MazeT< WIDTH , HEIGHT >::recordWavefront( const Board& wavefront , unsigned short* costs , int cost )
+	{
+		int numNodes = 0;
+
+		for ( int y = 0; y < NUM_NODES_H; y++ )
+		{
+			typename Board::Row bits = wavefront.getRow( y );
+
+			while ( bits != 0 )
+			{
+				int x = Board::lowestBit( bits );
+				bits &= bits - 1;
+
+				int index = Geometry::getIndex( x , y );
+
+				touchNode( index );
+				costs[ index ] = cost;
+				numNodes++;
+			}
+		}
+
+		searchStats.nodesExpanded += numNodes;
+
+		return numNodes;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	void MazeT< WIDTH , HEIGHT >::traceWavefront( int endNode , int startNode )
+	{
+		const direction straightDirections[] = { N , E , S , W };
+
+		// walk back from the end node, each parent is a neighbor the wavefront reached one move earlier
+		int node = endNode;
+
+		while ( node != startNode )
+		{
+			for ( int d = 0; d < 4; d++ )
+			{
+				int neighborNode = getNeighborIndex( node , straightDirections[ d ] );
+
+				if ( neighborNode != NO_NODE && nodeStamp[ neighborNode ] == searchEpoch && nodeG[ neighborNode ] + STRAIGHT_COST == nodeG[ node ] )
+				{
+					// the path moves from the neighbor back to this node
+					nodeParent[ node ] = neighborNode;
+					nodeDir[ node ] = straightDirections[ d ] + S;
+					break;
+				}
+			}
+
+			node = nodeParent[ node ];
+		}
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	int MazeT< WIDTH , HEIGHT >::searchJumpPoint( PositionVector start , PositionVector end , bool isMapping )
+	{
+		const direction straightDirections[] = { N , E , S , W };
+
+		// the nodes the scans may enter, the posts outside the center are never present
+		Board open = nodePresent;
+
+		if ( !isMapping )
+		{
+			open.andWith( nodeExplored ); // Ignore the unexplored nodes if we arent mapping
+		}
+
+		int endNode = getIndex( end );
+		int startNode = getIndex( start );
+
+		openHeap.clear();
+
+		touchNode( startNode );
+		nodeG[ startNode ] = 0;
+		nodeF[ startNode ] = estimateCost( startNode );
+		openHeap.push( startNode , nodeF[ startNode ] );
+
+		while ( !openHeap.empty() )
+		{
+			int currentNode = openHeap.pop();
+			searchStats.nodesExpanded++;
+
+			if ( currentNode == endNode )
+			{
+				// the parents skip along the scans, so fill in the nodes between each jump point and its parent
+				int node = endNode;
+
+				while ( nodeParent[ node ] != NO_NODE )
+				{
+					int parentNode = nodeParent[ node ];
+					direction dir = static_cast< direction >( nodeDir[ node ] );
+
+					while ( node - Geometry::INDEX_OFFSET[ dir ] != parentNode )
+					{
+						int previousNode = node - Geometry::INDEX_OFFSET[ dir ];
+
+						touchNode( previousNode );
+						nodeParent[ node ] = previousNode;
+						nodeDir[ previousNode ] = dir;
+						node = previousNode;
+					}
+
+					nodeParent[ node ] = parentNode;
+					node = parentNode;
+				}
+
+				return endNode;
+			}
+
+			setFlag( nodeClosed , currentNode , true );
+
+			int x = currentNode / NUM_NODES_H;
+			int y = currentNode % NUM_NODES_H;
+
+			for ( int d = 0; d < 4; d++ )
+			{
+				direction dir = straightDirections[ d ];
+
+				// a shortest path never goes back the way it came, every other direction may be a turn
+				if ( nodeParent[ currentNode ] != NO_NODE && dir == static_cast< direction >( nodeDir[ currentNode ] ) + S )
+				{
+					continue;
+				}
+
+				int jumpNode = jump( x , y , dir , endNode , open );
+
+				if ( jumpNode == NO_NODE )
+				{
+					continue;
+				}
+
+				touchNode( jumpNode );
+
+				if ( getFlag( nodeClosed , jumpNode ) )
+				{
+					continue;
+				}
+
+				int moves = abs( jumpNode / NUM_NODES_H - x ) + abs( jumpNode % NUM_NODES_H - y );
+				int tentative_G = nodeG[ currentNode ] + moves * STRAIGHT_COST;
+
+				if ( tentative_G >= nodeG[ jumpNode ] )
+				{
+					continue;
+				}
+
+				nodeParent[ jumpNode ] = currentNode;
+				nodeDir[ jumpNode ] = dir;
+				nodeG[ jumpNode ] = tentative_G;
+				nodeF[ jumpNode ] = tentative_G + estimateCost( jumpNode );
+
+				openHeap.push( jumpNode , nodeF[ jumpNode ] );
+			}
+		}
+
+		return NO_NODE;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	int MazeT< WIDTH , HEIGHT >::jump( int x , int y , direction dir , int endNode , const Board& open ) const
+	{
+		int fromX = x;
+		int fromY = y;
+		bool isVertical = dir == N || dir == S;
+
+		for ( ;; )
+		{
+			x += Geometry::DX[ dir ];
+			y += Geometry::DY[ dir ];
+
+			if ( !open.get( x , y ) )
+			{
+				return NO_NODE;
+			}
+
+			int index = Geometry::getIndex( x , y );
+
+			if ( index == endNode ||
+				isForcedTurn( x , y , dir , dir + E , fromX , fromY , endNode , open ) ||
+				isForcedTurn( x , y , dir , dir + W , fromX , fromY , endNode , open ) )
+			{
+				return index;
+			}
+
+			// the east and west scans from here find the turns off of this line
+			if ( isVertical && ( jump( x , y , E , endNode , open ) != NO_NODE || jump( x , y , W , endNode , open ) != NO_NODE ) )
+			{
+				return index;
+			}
+		}
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	bool MazeT< WIDTH , HEIGHT >::isForcedTurn( int x , int y , direction dir , direction side , int fromX , int fromY , int endNode , const Board& open ) const
+	{
+		int sideX = x + Geometry::DX[ side ];
+		int sideY = y + Geometry::DY[ side ];
+
+		if ( !open.get( sideX , sideY ) )
+		{
+			return false;
+		}
+
+		if ( Geometry::getIndex( sideX , sideY ) == endNode )
+		{
+			return true;
+		}
+
+		int backX = Geometry::DX[ dir + S ];
+		int backY = Geometry::DY[ dir + S ];
+
+		// like jump point search on a grid of cells, the turn is forced when the node beside the one
+		// before is blocked, since no path of the same length could have turned earlier
+		if ( Geometry::isValidPosition( sideX + backX , sideY + backY ) )
+		{
+			return !open.get( sideX + backX , sideY + backY );
+		}
+
+		// but the node beside the one before is a post, which would force a turn at every cell with an
+		// opening on its side. A path of the same length turns at the cell before instead, through the edge
+		// beside it, the next cell over and the edge between that cell and the one beside ( x , y ),
+		// unless the scan started on the edge before this cell, or the edge beside ( x , y ) also leads
+		// ahead to the post in the center
+		int cellX = x + 2 * backX;
+		int cellY = y + 2 * backY;
+
+		if ( ( cellX - fromX ) * backX + ( cellY - fromY ) * backY > 0 || Geometry::isValidPosition( sideX - backX , sideY - backY ) )
+		{
+			return true;
+		}
+
+		return !open.get( cellX + Geometry::DX[ side ] , cellY + Geometry::DY[ side ] ) ||
+			!open.get( cellX + 2 * Geometry::DX[ side ] , cellY + 2 * Geometry::DY[ side ] ) ||
+			!open.get( sideX + Geometry::DX[ side ] + backX , sideY + Geometry::DY[ side ] + backY );
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	int MazeT< WIDTH , HEIGHT >::searchIncremental()
+	{
+		if ( !incrementalPlanner.findPath( searchStats.nodesExpanded ) )
+		{
+			return NO_NODE;
+		}
+
+		int start = getIndex( incrementalPlanner.getStart() );
+		int goal = getIndex( incrementalPlanner.getGoal() );
+
+		// the planner only keeps costs, so the parents are set along the path
+		// the other nodes are not touched, which is why resetNodes() is not needed
+		for ( int index = goal; index != start; index = nodeParent[ index ] )
+		{
+			direction moveDir = incrementalPlanner.getPathDirection( PositionVector( index / NUM_NODES_H , index % NUM_NODES_H ) );
+
+			nodeParent[ index ] = index + Geometry::INDEX_OFFSET[ moveDir + S ];
+			nodeDir[ index ] = moveDir;
+		}
+
+		nodeParent[ start ] = NO_NODE;
+		nodeDir[ start ] = NONE;
+
+		return goal;
+	}
+
+
+
+	// Returns true if there is a Node at the given position.
+	template < int WIDTH , int HEIGHT >
+	bool MazeT< WIDTH , HEIGHT >::hasNode( PositionVector pos ) const
+	{
+		if ( pos.x() < 0 || pos.x() >= NUM_NODES_W || pos.y() < 0 || pos.y() >= NUM_NODES_H )
+		{
+			return false;
+		}
+
+		return nodePresent.get( pos.x() , pos.y() );
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	int MazeT< WIDTH , HEIGHT >::estimateCost( int index ) const
+	{
+		int dx = abs( index / NUM_NODES_H - searchEndX );
+		int dy = abs( index % NUM_NODES_H - searchEndY );
+
+		switch ( heuristic )
+		{
+		case MANHATTAN:
+			return STRAIGHT_COST * ( dx + dy );
+
+		case OCTILE:
+			// move diagonally until lined up with the end, then straight
+			return STRAIGHT_COST * ( dx + dy ) + ( DIAGONAL_COST - 2 * STRAIGHT_COST ) * ( dx < dy ? dx : dy );
+
+		case LOWER_BOUND:
+			return searchLowerBounds[ index ];
+
+		case NO_HEURISTIC:
+		default:
+			return 0;
+		}
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	const unsigned short * MazeT< WIDTH , HEIGHT >::getLowerBounds( PositionVector end )
+	{
+		int endIndex = getIndex( end );
+
+		// find the table for 'end', or stop at the least recently used table
+		int i = 0;
+
+		while ( i < NUM_LOWER_BOUND_TABLES - 1 && lowerBoundEnds[ i ] != endIndex )
+		{
+			i++;
+		}
+
+		unsigned short* table = lowerBoundTables[ i ];
+
+		if ( lowerBoundEnds[ i ] != endIndex )
+		{
+			if ( table == nullptr )
+			{
+				table = new unsigned short[ NUM_NODES_W * NUM_NODES_H ];
+			}
+
+			computeLowerBounds( table , end );
+		}
+
+		// move the table to the front of the cache
+		for ( ; i > 0; i-- )
+		{
+			lowerBoundTables[ i ] = lowerBoundTables[ i - 1 ];
+			lowerBoundEnds[ i ] = lowerBoundEnds[ i - 1 ];
+		}
+
+		lowerBoundTables[ 0 ] = table;
+		lowerBoundEnds[ 0 ] = endIndex;
+
+		return table;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	void MazeT< WIDTH , HEIGHT >::computeLowerBounds( unsigned short * table , PositionVector end ) const
+	{
+		const direction straightDirections[] = { N , E , S , W };
+
+		// breadth first search from 'end' over every valid position
+		unsigned short queue[ NUM_NODES_W * NUM_NODES_H ];
+		int head = 0;
+		int tail = 0;
+
+		for ( int i = 0; i < NUM_NODES_W * NUM_NODES_H; i++ )
+		{
+			table[ i ] = INF;
+		}
+
+		table[ getIndex( end ) ] = 0;
+		queue[ tail++ ] = getIndex( end );
+
+		while ( head < tail )
+		{
+			int index = queue[ head++ ];
+			PositionVector pos( index / NUM_NODES_H , index % NUM_NODES_H );
+
+			for ( int d = 0; d < 4; d++ )
+			{
+				PositionVector neighborPos = pos + straightDirections[ d ];
+
+				if ( !Geometry::isValidPosition( neighborPos.x() , neighborPos.y() ) || table[ getIndex( neighborPos ) ] != INF )
+				{
+					continue;
+				}
+
+				table[ getIndex( neighborPos ) ] = table[ index ] + STRAIGHT_COST;
+				queue[ tail++ ] = getIndex( neighborPos );
+			}
+		}
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	int MazeT< WIDTH , HEIGHT >::getIndex( PositionVector pos ) const
+	{
+		return Geometry::getIndex( pos.x() , pos.y() );
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	PositionVector MazeT< WIDTH , HEIGHT >::getPos( int index ) const
+	{
+		return PositionVector( index / NUM_NODES_H , index % NUM_NODES_H );
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	int MazeT< WIDTH , HEIGHT >::getNeighborIndex( int index , direction dir ) const
+	{
+		if ( dir == NONE || dir % 2 != 0 )
+		{
+			return NO_NODE; // diagonal moves are not allowed
+		}
+
+		int x = index / NUM_NODES_H + Geometry::DX[ dir ];
+		int y = index % NUM_NODES_H + Geometry::DY[ dir ];
+
+		// positions outside the maze are never present, and are at most one step outside the grid
+		return nodePresent.getUnchecked( x , y ) ? index + Geometry::INDEX_OFFSET[ dir ] : NO_NODE;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	int MazeT< WIDTH , HEIGHT >::getDiagonalNeighborIndex( int index , direction dir ) const
+	{
+		assert( dir == NE || dir == SE || dir == SW || dir == NW );
+
+		int x = index / NUM_NODES_H;
+		int y = index % NUM_NODES_H;
+		int toX = x + Geometry::DX[ dir ];
+		int toY = y + Geometry::DY[ dir ];
+
+		if ( !nodePresent.getUnchecked( toX , toY ) )
+		{
+			return NO_NODE;
+		}
+
+		// the nodes beside the move, one is a post unless the move is inside the center
+		// the target is inside the grid, so these are too
+		bool besideX = nodePresent.getUnchecked( toX , y ) || ( toX % 2 != 0 && y % 2 != 0 );
+		bool besideY = nodePresent.getUnchecked( x , toY ) || ( x % 2 != 0 && toY % 2 != 0 );
+
+		return besideX && besideY ? index + Geometry::INDEX_OFFSET[ dir ] : NO_NODE;
+	}
+
+
+
+	// adds a new node to the maze at the given position
+	template < int WIDTH , int HEIGHT >
+	void MazeT< WIDTH , HEIGHT >::addNode( PositionVector pos )
+	{
+		assert( Geometry::isValidPosition( pos.x() , pos.y() ) );
+
+		// adding an explored node again clears its explored flag, see copyNodes
+		if ( hasNode( pos ) && !isExplored( pos ) )
+		{
+			return;
+		}
+
+		nodePresent.set( pos.x() , pos.y() , true );
+		nodeExplored.set( pos.x() , pos.y() , false );
+
+		for ( int i = 0; i < numListeners; i++ )
+		{
+			listeners[ i ]->updateNode( pos );
+		}
+
+		revision++;
+	}
+
+	template < int WIDTH , int HEIGHT >
+	void MazeT< WIDTH , HEIGHT >::removeNode(PositionVector pos)
+	{
+		assert( Geometry::isValidPosition( pos.x() , pos.y() ) );
+
+		// lookAround removes every wall it sees, most of them again
+		if ( !hasNode( pos ) )
+		{
+			return;
+		}
+
+		nodePresent.set( pos.x() , pos.y() , false );
+		nodeExplored.set( pos.x() , pos.y() , false );
+
+		for ( int i = 0; i < numListeners; i++ )
+		{
+			listeners[ i ]->updateNode( pos );
+		}
+
+		revision++;
+	}
+
+
+
+	// returns true if there is a neighbor node at direction dir from pos
+	template < int WIDTH , int HEIGHT >
+	bool MazeT< WIDTH , HEIGHT >::hasNeighborNode( PositionVector pos , direction dir ) const
+	{
+		if ( dir == NW || dir == SW || dir == SE || dir == NE )
+		{
+			return false;
+		}
+
+		/*       x
+			 -1  0  1
+			----------
+		  1| NW| N |NE|
+		   |---+---+--|
+		y 0| W |   | E|
+		   |---+---+--|
+		 -1| SW| s  SE|
+			----------
+		*/
+
+		return hasNode( pos + dir );
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	void MazeT< WIDTH , HEIGHT >::setExplored( PositionVector pos )
+	{
+		if ( hasNode( pos ) && !isExplored( pos ) )
+		{
+			nodeExplored.set( pos.x() , pos.y() , true );
+
+			for ( int i = 0; i < numListeners; i++ )
+			{
+				if ( listenerExplored[ i ] )
+				{
+					listeners[ i ]->updateNode( pos );
+				}
+			}
 
-			// a NodePairList should on be used during mapping
-			assert(isMapping);
+			revision++;
 		}
+	}
 
-		std::vector< Node* > openNodes;
 
-		// assume 1/2 of the maze will need to be searched on average;
-		// this prevents too many resizes, idk if this is optimal I was just estimating
-		openNodes.reserve( static_cast< int >( NUM_NODES_W * NUM_NODES_H * 0.5f ) );
 
-		// the start node is added to openNodes
-		openNodes.push_back( getNode( start ) );
+	template < int WIDTH , int HEIGHT >
+	bool MazeT< WIDTH , HEIGHT >::isExplored(PositionVector pos) const
+	{
+		return nodeExplored.get( pos.x() , pos.y() );
+	}
 
-		// initialize the movement cost to 0 for the first node
-		getNode( start )->setG( 0 );
 
-		Node* currentNode;
-		Node* neighborNode;
-		int tentative_G;
 
-		// While there are still open nodes remaining
-		while ( !openNodes.empty() )
-		{
-			// sort the nodes in descending order by F value
-			// we sort by descending so we can later us pop_back()
-			std::sort( openNodes.begin() , openNodes.end() , nodeComparator ); 
+	template < int WIDTH , int HEIGHT >
+	const BitBoardT< WIDTH , HEIGHT >& MazeT< WIDTH , HEIGHT >::getNodes() const
+	{
+		return nodePresent;
+	}
 
-			// get the node with the lowest F value
-			currentNode = openNodes.back();
 
-			// if we are at the end node then we are done!
-			if ( currentNode == getNode( end ) ) 
-			{
-				// create a Path object for motion control to utilize
-				return createPath( currentNode, isMapping, passageNodes ); 
-			}
 
-			openNodes.pop_back();
-			currentNode->close();
+	template < int WIDTH , int HEIGHT >
+	const BitBoardT< WIDTH , HEIGHT >& MazeT< WIDTH , HEIGHT >::getExploredNodes() const
+	{
+		return nodeExplored;
+	}
 
-			// loop through neighbor nodes
-			for ( direction dir = N; dir != NONE; ++dir )
+
+
+	template < int WIDTH , int HEIGHT >
+	void MazeT< WIDTH , HEIGHT >::copyNodes( const Board& present , const Board& explored )
+	{
+		for ( int y = 0; y < NUM_NODES_H; y++ )
+		{
+			typename Board::Row changed = ( nodePresent.getRow( y ) ^ present.getRow( y ) ) | ( nodeExplored.getRow( y ) ^ explored.getRow( y ) );
+
+			while ( changed != 0 )
 			{
-				neighborNode = getNeighborNode( currentNode->getPos() , dir );
+				int x = Board::lowestBit( changed );
+				changed &= changed - 1;
 
-				if ( neighborNode == nullptr )
-				{
-					continue; // there is no neighbor node in this direction
-				}
+				PositionVector pos( x , y );
 
-				if ( neighborNode->isClosed() )
+				if ( !present.get( x , y ) )
 				{
-					continue; // Ignore the neighbor which is already evaluated
+					removeNode( pos );
+					continue;
 				}
 
-				if ( !isMapping && !neighborNode->isExplored())
+				// a node can only lose its explored flag by being added again
+				if ( !hasNode( pos ) || isExplored( pos ) )
 				{
-					continue; // Ignore the unexplored nodes if we arent mapping
+					addNode( pos );
 				}
 
-
-				tentative_G = currentNode->getG();
-
-				// if moved diagnal add 14, else moved straight add 10
-				tentative_G += ( dir == direction::NW || dir == direction::SW || dir == direction::NE || dir == direction::SE ) ? 14 : 10; 
-
-
-				//if neighborNode is not already in openNodes then add id
-				if ( std::find( openNodes.begin() , openNodes.end() , neighborNode ) == openNodes.end() )
-				{
-					openNodes.push_back( neighborNode );
-				}
-				// else the neighborNode is already in openNodes
-				// if new path to neighborNode is worse than previous
-				else if ( tentative_G >= neighborNode->getG() )
+				if ( explored.get( x , y ) )
 				{
-					continue; //this is not a better path
+					setExplored( pos );
 				}
-
-				//if we made it to this point then
-				//this path is the best so far
-				neighborNode->setParent( currentNode );
-				neighborNode->setDir( dir );
-				neighborNode->setG( tentative_G );
-				neighborNode->setF( tentative_G + 0 /*TODO calculate Hueristic here*/ );
 			}
 		}
-
-		// no path was found
-		// this should never happen in real maze
-		// TODO throw error if this is reached in real testing
-		return nullptr;
 	}
 
 
 
-
-
-
-	// Retruns the Node at the given position.
-	Node* Maze::getNode( PositionVector pos ) const
+	template < int WIDTH , int HEIGHT >
+	void MazeT< WIDTH , HEIGHT >::addListener( NodeListener* listener , bool explored )
 	{
-		return maze[ pos.x() ][ pos.y() ];
-	}
+		assert( numListeners < MAX_LISTENERS );
 
+		listeners[ numListeners ] = listener;
+		listenerExplored[ numListeners ] = explored;
+		numListeners++;
+	}
 
 
-	// adds a new node to the maze at the given position
-	void Maze::addNode( PositionVector pos )
-	{
-		assert(pos.isValidPosition());
-		maze[pos.x()][pos.y()] = new Node(pos);
-	}
 
-	void Maze::removeNode(PositionVector pos)
+	template < int WIDTH , int HEIGHT >
+	bool MazeT< WIDTH , HEIGHT >::isDeadEnd( PositionVector pos )
 	{
-		assert(pos.isValidPosition());
-		delete maze[pos.x()][pos.y()];
-		maze[pos.x()][pos.y()] = nullptr;
+		return exploredPruner.getPruned().get( pos.x() , pos.y() );
 	}
 
 
 
-	// returns a pointer to the neighbor node at direction dir from pos
-	Node * Maze::getNeighborNode( PositionVector pos , direction dir )
+	template < int WIDTH , int HEIGHT >
+	int MazeT< WIDTH , HEIGHT >::getDistance( PositionVector from , PositionVector to )
 	{
-		// Uses old direction enum order
-		// int x = pos.x() + dir % 3 - 1;
-		// int y = pos.y() + dir / 3 - 1;
-		//if (x >= 0 && x < NUM_NODES_W && y >= 0 && y < NUM_NODES_H) { return maze[x][y]; }
+		if ( distanceTable == nullptr )
+		{
+			distanceTable = new DistanceTableT< WIDTH , HEIGHT >( *this , DISTANCE_TABLE_ALL_PAIRS );
+			addListener( distanceTable , true );
+		}
 
-		if ( dir == NW || dir == SW || dir == SE || dir == NE )
+		if ( !isExplored( from ) || !isExplored( to ) )
 		{
-			return nullptr;
+			return -1;
 		}
 
+		if ( distanceTable->hasRows( from , to ) )
+		{
+			return distanceTable->getDistance( from , to );
+		}
 
-		pos = pos + dir;
+		// without a row for either end the table would search too, and findPath is faster
+		Path path;
 
-		if (pos.x() >= 0 && pos.x() < NUM_NODES_W && pos.y() >= 0 && pos.y() < NUM_NODES_H) 
-		{ 
-			return maze[pos.x()][pos.y()]; 
+		if ( !findPath( from , to , path ) )
+		{
+			return -1;
 		}
 
+		int moves = 0;
 
-		/*       x
-			 -1  0  1
-			----------
-		  1| NW| N |NE|
-		   |---+---+--|
-		y 0| W |   | E|
-		   |---+---+--|
-		 -1| SW| s  SE|
-			----------
-		*/
+		for ( int i = 0; i < path.size(); i++ )
+		{
+			moves += path.getStep( i ).mag();
+		}
 
-		return nullptr;
+		return moves;
 	}
 
 
 
-	void Maze::setExplored( PositionVector pos )
+	template < int WIDTH , int HEIGHT >
+	const typename MazeT< WIDTH , HEIGHT >::Board* MazeT< WIDTH , HEIGHT >::getSkippedNodes( PositionVector start , PositionVector end , bool isRun )
 	{
-		Node* node = getNode(pos);
-
-		if (node != nullptr)
+		if ( !deadEndPruning )
 		{
-			node->setExplored();
+			return nullptr;
 		}
-	}
-
 
+		DeadEndPrunerT< WIDTH , HEIGHT >& pruner = isRun ? presentPruner : exploredPruner;
+		const Board& deadEnds = pruner.getPruned();
 
-	bool Maze::isExplored(PositionVector pos) const
-	{
-		Node* node = getNode(pos);
-
-		if (node != nullptr)
+		// no shortest path between two nodes outside the dead ends enters one
+		if ( deadEnds.get( start.x() , start.y() ) || deadEnds.get( end.x() , end.y() ) )
 		{
-			return node->isExplored();
+			return nullptr;
 		}
 
-		return false;
+		return isRun ? &pruner.getDeepPruned() : &deadEnds;
 	}
 
 
 
-	Path * Maze::createPath( const Node * node , bool isMapping , NodePairList* passageNodes)
+	template < int WIDTH , int HEIGHT >
+	void MazeT< WIDTH , HEIGHT >::createPath( int node , Path& path , bool isMapping , NodePairList* passageNodes)
 	{
-		Path* path = new Path;
-		direction travelDir = node->getDir();
+		direction travelDir = static_cast< direction >( nodeDir[ node ] );
 
-		const Node* passageNodeTemp;
-		const Node* previousNode = node;
+		int passageNodeTemp = NO_NODE;
+		int previousNode = node;
 
 		int magnitude = 1;
-		node = node->getParent();
+		node = nodeParent[ node ];
 
 		// used to detect the transition between explored and unexplored nodes
 		// if the edge detectors are not equal then an edge is present
@@ -247,23 +1571,22 @@ namespace Micromouse
 
 
 		// while there is more to the path to traverse
-		while ( node != nullptr )
+		while ( node != NO_NODE )
 		{
 			//if we are at the beginning of the path or if the path is not straight 
 			// or we are mapping 
-			if ( isMapping || node->getDir() != travelDir || passageNodes != nullptr)
+			if ( isMapping || nodeDir[ node ] != travelDir || passageNodes != nullptr)
 			{
 				// add a step to the path to define the direction and distance needed to travel
-				path->addStep(DirectionVector(travelDir, magnitude));
+				path.addStep(DirectionVector(travelDir, magnitude));
 
-				travelDir = node->getDir();
+				travelDir = static_cast< direction >( nodeDir[ node ] );
 				magnitude = 0;
 			}
 			//else the path is straight so no need for a step
 
 			
-			// the short circuit protects the second half of the boolean expression
-			edgeDetectorA = (node != nullptr && node->isExplored());
+			edgeDetectorA = nodeExplored.get( node / NUM_NODES_H , node % NUM_NODES_H );
 
 			// if the edgeDectors are not equal then we are at a boundary between
 			// explored and unexplored nodes
@@ -282,100 +1605,331 @@ namespace Micromouse
 				{
 					// we now have a pair of nodes that represent an entrance
 					// and exit from unexplored nodes
-					passageNodes->push_back( std::make_pair( node , passageNodeTemp) );
+					passageNodes->push_back( std::make_pair( getPos( node ) , getPos( passageNodeTemp ) ) );
 				}
 			}
 
 			previousNode = node;
-			node = node->getParent();
+			node = nodeParent[ node ];
 
 			edgeDetectorB = edgeDetectorA;
 
 			magnitude++;
 		}
-
-		return path;
 	}
 
 
 
 	// populates the maze with Nodes
-	void Maze::initNodes()
+	template < int WIDTH , int HEIGHT >
+	void MazeT< WIDTH , HEIGHT >::initNodes()
 	{
+		// every stamp is older than the first search
+		for ( int i = 0; i < NUM_NODES; i++ )
+		{
+			nodeStamp[ i ] = 0;
+		}
+
+		searchEpoch = 0;
+
 		for ( int x = 0; x < NUM_NODES_W; x++ )
 		{
 			for ( int y = 0; y < NUM_NODES_H; y++ )
 			{
-				if (isValidPosition( x, y) )
+				if ( Geometry::isValidPosition( x , y ) )
 				{
-					maze[ x ][ y ] = new Node( PositionVector(x,y) );
-				}
-				else
-				{
-					maze[x][y] = nullptr;
+					nodePresent.set( x , y , true );
 				}
 			}
 		}
+
+		resetNodes();
 	}
 
 
 
-	void Maze::resetNodes()
+	template < int WIDTH , int HEIGHT >
+	void MazeT< WIDTH , HEIGHT >::resetNodes()
 	{
-		for (size_t i = 0; i < NUM_NODES_W; i++)
+		searchEpoch++;
+
+		// after wrapping around an old stamp could match the new epoch,
+		// so every stamp is cleared once every 65535 searches
+		if ( searchEpoch == 0 )
 		{
-			for (size_t j = 0; j < NUM_NODES_H; j++)
+			for ( int i = 0; i < NUM_NODES; i++ )
 			{
-				if (maze[i][j] != nullptr)
-				{
-					maze[i][j]->reset();
-				}
+				nodeStamp[ i ] = 0;
 			}
+
+			searchEpoch = 1;
+		}
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	void MazeT< WIDTH , HEIGHT >::touchNode( int index )
+	{
+		if ( nodeStamp[ index ] == searchEpoch )
+		{
+			return;
+		}
+
+		nodeStamp[ index ] = searchEpoch;
+		nodeG[ index ] = INF;
+		nodeF[ index ] = INF;
+		nodeParent[ index ] = NO_NODE;
+		nodeDir[ index ] = NONE;
+		setFlag( nodeClosed , index , false );
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	bool MazeT< WIDTH , HEIGHT >::getFlag( const unsigned int * flags , int index ) const
+	{
+		return ( flags[ index / 32 ] >> ( index % 32 ) ) & 1;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	void MazeT< WIDTH , HEIGHT >::setFlag( unsigned int * flags , int index , bool flag )
+	{
+		if ( flag )
+		{
+			flags[ index / 32 ] |= 1u << ( index % 32 );
+		}
+		else
+		{
+			flags[ index / 32 ] &= ~( 1u << ( index % 32 ) );
 		}
 	}
 
 
 
 
-	void Maze::removeExcessFinshNodes()
+	template < int WIDTH , int HEIGHT >
+	void MazeT< WIDTH , HEIGHT >::removeExcessFinshNodes()
 	{
-		Node * tempNode;
 		for (int i = -2; i <= 2; i++)
 		{
 			for (int j = -2; j <= 2; j++)
 			{
-				tempNode = getNode(PositionVector(i, j) + PositionVector::FINISH);
-				if (tempNode != nullptr && !tempNode->isExplored())
+				PositionVector tempPos = PositionVector(i, j) + getFinish();
+				if (hasNode(tempPos) && !isExplored(tempPos))
 				{
-					removeNode(PositionVector(i, j) + PositionVector::FINISH);
+					removeNode(tempPos);
 				}
 			}
 		}
 	}
 
 
+
+	template < int WIDTH , int HEIGHT >
+	void MazeT< WIDTH , HEIGHT >::reset()
+	{
+		nodePresent.clear();
+		nodeExplored.clear();
+		initNodes();
+
+		// the LOWER_BOUND tables do not depend on the walls so they stay cached
+		for ( int i = 0; i < numListeners; i++ )
+		{
+			listeners[ i ]->reset();
+		}
+
+		// the run planner keeps nothing between searches, so it is only kept while runs are planned
+		delete runPlanner;
+		runPlanner = nullptr;
+
+		revision++;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	PositionVector MazeT< WIDTH , HEIGHT >::getFinish()
+	{
+		return PositionVector( WIDTH - 1 , HEIGHT - 1 );
+	}
+
+
+
+
+	void MazeBase::setSearchEngine( SearchEngine engine )
+	{
+		searchEngine = engine;
+		revision++;
+	}
+
+
+
+	MazeBase::SearchEngine MazeBase::getSearchEngine() const
+	{
+		return searchEngine;
+	}
+
+
+
+	void MazeBase::setHeuristic( Heuristic heuristic )
+	{
+		this->heuristic = heuristic;
+		revision++;
+	}
+
+
+
+	MazeBase::Heuristic MazeBase::getHeuristic() const
+	{
+		return heuristic;
+	}
+
+
+
+	void MazeBase::setIncrementalPlanning( bool enabled )
+	{
+		incrementalPlanning = enabled;
+		revision++;
+	}
+
+
+
+	bool MazeBase::getIncrementalPlanning() const
+	{
+		return incrementalPlanning;
+	}
+
+
+
+	void MazeBase::setCorridorContraction( bool enabled )
+	{
+		corridorContraction = enabled;
+		revision++;
+	}
+
+
+
+	bool MazeBase::getCorridorContraction() const
+	{
+		return corridorContraction;
+	}
+
+
+
+	void MazeBase::setDeadEndPruning( bool enabled )
+	{
+		deadEndPruning = enabled;
+		revision++;
+	}
+
+
+
+	bool MazeBase::getDeadEndPruning() const
+	{
+		return deadEndPruning;
+	}
+
+
+
+	void MazeBase::setAnytimeSlice( int maxExpansions , unsigned long maxMicros )
+	{
+		assert( maxExpansions > 0 );
+
+		anytimeSliceExpansions = maxExpansions;
+		anytimeSliceMicros = maxMicros;
+	}
+
+
+
+	int MazeBase::getAnytimeSliceExpansions() const
+	{
+		return anytimeSliceExpansions;
+	}
+
+
+
+	unsigned long MazeBase::getAnytimeSliceMicros() const
+	{
+		return anytimeSliceMicros;
+	}
+
+
+
+	void MazeBase::setMotionModel( const MotionModel& model )
+	{
+		motionModel = model;
+		revision++;
+	}
+
+
+
+	const MotionModel& MazeBase::getMotionModel() const
+	{
+		return motionModel;
+	}
+
+
+
+	const MazeBase::SearchStats & MazeBase::getSearchStats() const
+	{
+		return searchStats;
+	}
+
+
+
+	void MazeBase::resetSearchStats()
+	{
+		searchStats = SearchStats();
+	}
+
+
+
+	unsigned long MazeBase::getRevision() const
+	{
+		return revision;
+	}
+
+
+
+	void MazeBase::recordSearch( unsigned long nodesExpanded )
+	{
+		searchStats.searches++;
+		searchStats.lastNodesExpanded = searchStats.nodesExpanded - nodesExpanded;
+
+		if ( searchStats.lastNodesExpanded > searchStats.maxNodesExpanded )
+		{
+			searchStats.maxNodesExpanded = searchStats.lastNodesExpanded;
+		}
+	}
+
+
+
 #ifdef __MK20DX256__ // Teensy Compile
 #else // PC compile
-	std::ostream& operator<<(std::ostream& out, const Maze& maze)
+	template < int WIDTH , int HEIGHT >
+	std::ostream& operator<<(std::ostream& out, const MazeT< WIDTH , HEIGHT >& maze)
 	{
 		out << std::endl << "+ ";
 
-		for (int x = 0; x < NUM_NODES_W; x++)
+		for (int x = 0; x < MazeT< WIDTH , HEIGHT >::NUM_NODES_W; x++)
 		{
 			out << "- ";
 		}
 
 		out << "+" << std::endl;
 
-		for (int y = NUM_NODES_H - 1; y >= 0; y--)
+		for (int y = MazeT< WIDTH , HEIGHT >::NUM_NODES_H - 1; y >= 0; y--)
 		{
 			out << "| ";
 
-			for (int x = 0; x < NUM_NODES_W; x++)
+			for (int x = 0; x < MazeT< WIDTH , HEIGHT >::NUM_NODES_W; x++)
 			{
 				if (maze.isExplored(PositionVector(x,y)))
 				{
-					if (maze.getNode(PositionVector(x,y)) != nullptr)
+					if (maze.hasNode(PositionVector(x,y)))
 					{
 						out << "  ";
 					}
@@ -405,7 +1959,7 @@ namespace Micromouse
 
 		out << "+ ";
 
-		for (int x = 0; x < NUM_NODES_W; x++)
+		for (int x = 0; x < MazeT< WIDTH , HEIGHT >::NUM_NODES_W; x++)
 		{
 			out << "- ";
 		}
@@ -415,4 +1969,17 @@ namespace Micromouse
 		return out;
 	}
 #endif
-}
\ No newline at end of file
+
+
+
+	// the classic and the half size competition mazes, only the simulator builds the half size one
+	template class MazeT< 16 , 16 >;
+
+#ifdef __MK20DX256__ // Teensy Compile
+#else // PC compile
+	template class MazeT< 32 , 32 >;
+
+	template std::ostream& operator<<(std::ostream& out, const MazeT< 16 , 16 >& maze);
+	template std::ostream& operator<<(std::ostream& out, const MazeT< 32 , 32 >& maze);
+#endif
+}
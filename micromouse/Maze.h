@@ -1,8 +1,19 @@
 #pragma once
-#include "Node.h"
 #include "Vector.h"
+#include "MazeGeometry.h"
 #include "Path.h"
-#include "FlagMatrix.h"
+#include "NodeHeap.h"
+#include "BucketQueue.h"
+#include "IncrementalPlanner.h"
+#include "RunPlanner.h"
+#include "CorridorGraph.h"
+#include "DeadEndPruner.h"
+#include "DistanceTable.h"
+#include "ModifiedFloodFill.h"
+#include "AnytimePlanner.h"
+#include "MotionModel.h"
+#include "BitBoard.h"
+#include "NodeListener.h"
 
 #include <vector>
 #include <utility>//pair
@@ -10,34 +21,216 @@
 
 namespace Micromouse
 {
-	typedef std::pair<const Node*, const Node*> NodePair;
+	typedef std::pair<PositionVector, PositionVector> NodePair;
 	typedef std::vector<NodePair> NodePairList;
 
-	class Maze
+	// the search settings and counters of a maze, they are the same for every maze size
+	// so code that only configures a maze or reads its counters works with any MazeT
+	class MazeBase
 	{
 	public:
-		Maze();
-		~Maze();
+		// the open list implementations that findPath can use
+		// SORTED_LIST sorts every open node on each iteration, it is kept as a baseline for benchmarking
+		// BINARY_HEAP uses an indexed min-heap with decrease-key
+		// BUCKET_QUEUE uses a bucket queue (Dial's algorithm), possible because every move cost is a small integer
+		// FLOOD_FILL grows a breadth first wavefront over BitBoards a whole row at a time, it does not use
+		// the heuristic and relies on every move being straight, so every move costs the same
+		// BIDIRECTIONAL grows the FLOOD_FILL wavefront from both start and end until they meet,
+		// on long queries each side only covers about half the distance
+		// JUMP_POINT is A* that scans along straight lines and only opens the nodes where a shortest
+		// path may turn, which skips the equal cost paths through open areas like the center
+		enum SearchEngine { SORTED_LIST, BINARY_HEAP, BUCKET_QUEUE, FLOOD_FILL, BIDIRECTIONAL, JUMP_POINT };
 
+		// the estimates of the remaining cost to the end node that findPath can use
+		// all of them are admissible, they never estimate more than the real cost
+		// NO_HEURISTIC always estimates 0, which makes findPath Dijkstra's algorithm
+		// MANHATTAN is the straight move cost times the Manhattan distance
+		// OCTILE is the shortest distance when diagonal moves are allowed
+		// LOWER_BOUND is the exact cost in a maze with no walls, which also accounts for the
+		// wall posts between nodes. It is precomputed for each end node and cached
+		enum Heuristic { NO_HEURISTIC, MANHATTAN, OCTILE, LOWER_BOUND };
 
-		// TODO it should return a list of Vectors to utilized by the motion controller
-		Path * findPath( PositionVector start , PositionVector end , bool isMapping = false , NodePairList* passageNodes = nullptr );
+		// counters that are updated by every call to findPath
+		struct SearchStats
+		{
+			unsigned long searches = 0; // number of searches run by findPath, findRunPath and findPathToNearest
+			unsigned long nodesExpanded = 0; // number of nodes taken off of the open list
+			unsigned long lastNodesExpanded = 0; // nodes taken off of the open list by the last call
+			unsigned long maxNodesExpanded = 0; // the most nodes taken off of the open list by one call
+			unsigned long cacheHits = 0; // calls answered from the path cache, they are not counted as searches
+			unsigned long slices = 0; // slices of the anytime search, each one is also counted as a search
+			unsigned long maxSliceMicros = 0; // the longest slice of the anytime search in microseconds
+		};
 
-		// returns a Node from the maze
-		// 'pos' is the position of the Node being returned
-		Node* getNode(PositionVector pos) const;
+		// selects the open list implementation used by findPath, BINARY_HEAP by default
+		// with BINARY_HEAP the IncrementalPlanner and the CorridorGraph answer the queries they are enabled
+		// for and the engine only the rest, any other engine answers every findPath query itself
+		void setSearchEngine( SearchEngine engine );
+		SearchEngine getSearchEngine() const;
+
+		// selects the heuristic used by the search engine, MANHATTAN by default
+		// the queries answered by the IncrementalPlanner or the CorridorGraph do not use it
+		void setHeuristic( Heuristic heuristic );
+		Heuristic getHeuristic() const;
+
+		// when enabled the mapping query from START to FINISH is answered by an IncrementalPlanner,
+		// which repairs the previous search after nodes are removed instead of searching again
+		// the other queries always use the search engine, enabled by default, only used with BINARY_HEAP
+		void setIncrementalPlanning( bool enabled );
+		bool getIncrementalPlanning() const;
+
+		// when enabled the queries over explored nodes, from findPath and findPathToNearest,
+		// are answered by a CorridorGraph, which only expands the junctions between corridors
+		// the mapping queries always use the search engine, enabled by default, only used with BINARY_HEAP
+		void setCorridorContraction( bool enabled );
+		bool getCorridorContraction() const;
+
+		// when enabled findRunPath and the findPath queries answered by the CorridorGraph skip the dead ends
+		// found by a DeadEndPruner, as long as neither end of the query is in one, enabled by default
+		void setDeadEndPruning( bool enabled );
+		bool getDeadEndPruning() const;
+
+		// the limits of one slice of the anytime search, see MazeT::advanceAnytimeSearch
+		// a slice stops after 'maxExpansions' nodes, or once 'maxMicros' microseconds have passed if it is not 0
+		void setAnytimeSlice( int maxExpansions , unsigned long maxMicros );
+		int getAnytimeSliceExpansions() const;
+		unsigned long getAnytimeSliceMicros() const;
+
+		// the motion model that findRunPath predicts the run time with
+		void setMotionModel( const MotionModel& model );
+		const MotionModel& getMotionModel() const;
+
+		// returns the counters for every search since the last resetSearchStats()
+		const SearchStats& getSearchStats() const;
+		void resetSearchStats();
+
+		// returns a number that changes whenever the nodes or a setting that affects a search changes
+		// paths found at the same revision are still valid, see MazeT's path cache
+		unsigned long getRevision() const;
+
+	protected:
+		// updates the counters after a search, 'nodesExpanded' is searchStats.nodesExpanded before it
+		void recordSearch( unsigned long nodesExpanded );
+
+		SearchEngine searchEngine = BINARY_HEAP;
+		Heuristic heuristic = MANHATTAN;
+
+		// when the IncrementalPlanner answers the mapping query
+		bool incrementalPlanning = true;
+
+		// when the CorridorGraph answers the queries over explored nodes
+		bool corridorContraction = true;
+
+		// when the run searches skip the dead ends
+		bool deadEndPruning = true;
+
+		// the limits of one slice of the anytime search
+		int anytimeSliceExpansions = 64;
+		unsigned long anytimeSliceMicros = 200;
+
+		MotionModel motionModel;
+
+		SearchStats searchStats;
+
+		// increased by every change that can change a search result
+		unsigned long revision = 1;
+	};
+
+
+
+	// The maze the mouse has mapped so far, for a maze WIDTH cells wide and HEIGHT cells high.
+	// The sizes and lookup tables come from MazeGeometry at compile time, so each
+	// size gets its own search loops with the bounds and neighbor offsets folded in.
+	// The sizes the mouse and the simulator use are instantiated in Maze.cpp.
+	template < int WIDTH , int HEIGHT >
+	class MazeT : public MazeBase
+	{
+	public:
+		typedef MazeGeometry< WIDTH , HEIGHT > Geometry;
+
+		// the size of the node grid, these hide the global constants for the 16x16 maze
+		static const int NUM_NODES_W = Geometry::NUM_NODES_W;
+		static const int NUM_NODES_H = Geometry::NUM_NODES_H;
+
+		// a path long enough for any route through this maze
+		typedef PathT< Geometry::MAX_PATH_STEPS > Path;
+
+		MazeT();
+		~MazeT();
+
+		// a copy would free the structures it owns twice
+		MazeT( const MazeT& ) = delete;
+		MazeT& operator=( const MazeT& ) = delete;
+
+
+		// finds the shortest path from 'start' to 'end' and writes it into 'path'
+		// returns false and leaves 'path' empty if there is no path
+		// the caller owns 'path', so a search does not allocate
+		bool findPath( PositionVector start , PositionVector end , Path& path , bool isMapping = false , NodePairList* passageNodes = nullptr );
+
+		// finds the path from 'start' to 'end' over explored nodes with the lowest run time
+		// predicted by the motion model, for a mouse at 'start' facing 'facing', see RunPlanner
+		// every step of the path is one straight, returns false and leaves 'path' empty if there is no path
+		bool findRunPath( PositionVector start , direction facing , PositionVector end , Path& path );
+
+		// returns the predicted time in seconds of the last path found by findRunPath
+		float getRunPathTime() const;
+
+		// the modified flood fill, see ModifiedFloodFill, it counts unexplored nodes as open like mapping
+		// sets the distance of every node to the moves to 'goal', each later query only repairs the
+		// distances changed by the nodes added and removed since the last one, counted as one search
+		void setFloodGoal( PositionVector goal );
+
+		// returns the direction of a move from 'pos' one move nearer the flood goal, 'facing' if it is one,
+		// or NONE if 'pos' is the goal or cannot reach it, setFloodGoal must have been called
+		direction getFloodDirection( PositionVector pos , direction facing );
+
+		// returns the number of moves from 'pos' to the flood goal, or -1 if it cannot reach it
+		int getFloodDistance( PositionVector pos );
+
+		// the anytime search, see AnytimePlanner, for a control loop that cannot wait for findPath
+		// starts a search from 'start' to 'end', over the explored nodes or over every node if 'isMapping'
+		void startAnytimeSearch( PositionVector start , PositionVector end , bool isMapping = false );
+
+		// runs one slice of the search within the limits of setAnytimeSlice, counted as one search
+		// returns true once the search is done, a change to the maze since the last slice restarts it
+		bool advanceAnytimeSearch();
+
+		// fills 'path' with the best path found so far, the shortest path to end once the search found it,
+		// or else the path to the node it reached that looks nearest end, returns true if 'path' reaches end
+		bool getAnytimePath( Path& path ) const;
+
+		// finds the shortest path over explored nodes from 'start' to the nearest end of any pair
+		// in 'targets', in one search, and sets 'nearest' to that pair with the nearest end first
+		// returns false and leaves 'path' empty if no pair can be reached
+		bool findPathToNearest( PositionVector start , const NodePairList& targets , Path& path , NodePair& nearest );
+
+		// finds the number of moves over explored nodes from 'start' to both ends of every pair in 'targets'
+		// with one breadth first search that stops once it reached all of them, counted as one search
+		// getFoundDistance reads them until the next search
+		void findDistances( PositionVector start , const NodePairList& targets );
+
+		// returns the number of moves from the start of the last findDistances to 'pos',
+		// or -1 if it did not reach 'pos'
+		int getFoundDistance( PositionVector pos ) const;
+
+		// returns true if there is a node at 'pos'
+		// false if 'pos' is a wall or outside the maze
+		bool hasNode( PositionVector pos ) const;
 
 		// adds a Node to the Maze
 		// 'pos' is the position of the new Node being created
+		// an explored node loses its explored flag, adding an unexplored node that is there changes nothing
 		void addNode( PositionVector pos );
 
 		// removes a Node from the Maze
 		// 'pos' is the position of the Node being removed
+		// removing a node that is not there changes nothing, so the revision and the cached paths are kept
 		void removeNode(PositionVector pos);
 
-		// returns a pointer to the node in the direction 'dir' from the given Pos 'pos'
-		// if no such node exists then nullptr is returned
-		Node* getNeighborNode( PositionVector pos , direction dir );
+		// returns true if there is a node in the direction 'dir' from the given Pos 'pos'
+		// diagonal directions always return false
+		bool hasNeighborNode( PositionVector pos , direction dir ) const;
 
 
 		//Sets the explored flag at the given position.
@@ -50,33 +243,258 @@ namespace Micromouse
 		//bool isExplored(int x, int y) const;
 		bool isExplored(PositionVector pos) const;
 
+		// the nodes and the explored nodes, bit x of row y is the node at ( x , y )
+		const BitBoardT< WIDTH , HEIGHT >& getNodes() const;
+		const BitBoardT< WIDTH , HEIGHT >& getExploredNodes() const;
+
+		// gives this maze the nodes 'present' and the explored nodes 'explored', from another maze's
+		// getNodes() and getExploredNodes(), only the nodes that differ are added, removed or explored,
+		// so the planners only repair the changes
+		void copyNodes( const BitBoardT< WIDTH , HEIGHT >& present , const BitBoardT< WIDTH , HEIGHT >& explored );
+
+		// tells 'listener' about every later change to the nodes, see NodeListener, and about the nodes
+		// explored if 'explored', the maze does not own it and it must not be destroyed before the maze
+		// at most MAX_LISTENERS, the structures the maze keeps itself take up to 7 of them
+		void addListener( NodeListener* listener , bool explored );
+
+		// returns true if 'pos' is in a dead end of the explored maze, see DeadEndPruner
+		bool isDeadEnd( PositionVector pos );
+
+		// returns the number of moves of the shortest path over explored nodes from 'from' to 'to',
+		// or -1 if there is none or either of them is not explored
+		// the first call builds a DistanceTable, the later calls repair it with the nodes explored since,
+		// so on the host every call is a lookup, on the Teensy only the calls from or to START and FINISH
+		// are and the others run findPath
+		int getDistance( PositionVector from , PositionVector to );
+
 
 		// Once the opening to the cneter has been found the other
 		// nodes that form the wall around the center can be removed
 		void removeExcessFinshNodes();
 
+		// forgets every wall and explored node, as if the maze was just created
+		// the search settings and counters are kept, the RunPlanner is freed and the rest is not reallocated
+		void reset();
+
+		// returns the node in the center of this maze, PositionVector::FINISH for the 16x16 maze
+		static PositionVector getFinish();
+
+		// findPath and findRunPath keep the last few paths they found in a cache, so asking the same
+		// query again before the maze changes copies the path instead of searching
+		// the mapping queries that collect a NodePairList are never cached
+		static const int NUM_CACHED_PATHS = 2;
+
+		// the most NodeListeners a maze can tell about its changes
+		static const int MAX_LISTENERS = 10;
+
+
 	private:
+		// the planners read the nodes by index, see getNeighborIndex()
+		friend class IncrementalPlannerT< WIDTH , HEIGHT >;
+		friend class RunPlannerT< WIDTH , HEIGHT >;
+		friend class CorridorGraphT< WIDTH , HEIGHT >;
+		friend class DistanceTableT< WIDTH , HEIGHT >;
+		friend class ModifiedFloodFillT< WIDTH , HEIGHT >;
+		friend class AnytimePlannerT< WIDTH , HEIGHT >;
+
+		// the nodes are stored as one entry per position in each array, see getIndex()
+		static const int NUM_NODES = Geometry::NUM_NODES;
+
+		typedef BitBoardT< WIDTH , HEIGHT > Board;
+
+		// the parent of a node that has none
+		static const unsigned short NO_NODE = 0xFFFF;
+
+		// the search loops used by findPath
+		// each returns the index of the end node with the parents set back to start,
+		// or NO_NODE if there is no path
+		int searchSortedList( PositionVector start , PositionVector end , bool isMapping );
+
+		// the search loop for the indexed open lists, NodeHeap and BucketQueue
+		template < class OpenList >
+		int searchOpenList( OpenList& openList , PositionVector start , PositionVector end , bool isMapping );
+
+		// the breadth first search for FLOOD_FILL and findPathToNearest
+		// stops at the first of the 'ends' it reaches, and returns its index
+		int searchFloodFill( PositionVector start , const Board& ends , bool isMapping );
+
+		// the breadth first search for BIDIRECTIONAL, one wavefront grows from start with its costs in nodeG
+		// and one from end with its costs in nodeF, each step grows the one with fewer nodes
+		int searchBidirectional( PositionVector start , PositionVector end , bool isMapping );
+
+		// the A* search for JUMP_POINT, it opens the jump points with openHeap
+		// and sets the parents of every node of the path once it reaches end
+		int searchJumpPoint( PositionVector start , PositionVector end , bool isMapping );
 
-		// creates a Path object after findPath has been called
-		// 'node' is the finish node in the path
+		// scans from ( x , y ) in the direction 'dir' over the nodes in 'open' and returns the index of
+		// the first jump point, or NO_NODE if the scan is blocked first, 'dir' must be N, E, S or W
+		// a scan to the north or south also scans east and west from every node it passes
+		int jump( int x , int y , direction dir , int endNode , const Board& open ) const;
+
+		// returns true if a shortest path through ( x , y ), reached by a scan in the direction 'dir'
+		// that started at ( fromX , fromY ), may turn to its side 'side' there, see searchJumpPoint
+		bool isForcedTurn( int x , int y , direction dir , direction side , int fromX , int fromY , int endNode , const Board& open ) const;
+
+		// records 'cost' in 'costs' for every node in 'wavefront', returns the number of nodes
+		int recordWavefront( const Board& wavefront , unsigned short* costs , int cost );
+
+		// sets the parents from 'endNode' back to 'startNode' after a wavefront search,
+		// each parent is a neighbor with STRAIGHT_COST less in nodeG
+		void traceWavefront( int endNode , int startNode );
+
+		// sets the parents from FINISH back to START along the IncrementalPlanner's path
+		// returns the index of the end node, or NO_NODE if there is no path
+		int searchIncremental();
+
+		// returns the estimated cost from the node at 'index' to the end node of the current search
+		int estimateCost( int index ) const;
+
+		// returns the LOWER_BOUND table for 'end', computing it if it is not cached
+		const unsigned short* getLowerBounds( PositionVector end );
+
+		// fills 'table' with the cost from every position to 'end' in a maze with no walls
+		void computeLowerBounds( unsigned short* table , PositionVector end ) const;
+
+		// converts between a position and the index used by the node arrays and the open list
+		int getIndex( PositionVector pos ) const;
+		PositionVector getPos( int index ) const;
+
+		// returns the index of the neighbor of 'index' in the direction 'dir'
+		// or NO_NODE if there is no node there, the same as hasNeighborNode() without the PositionVectors
+		int getNeighborIndex( int index , direction dir ) const;
+
+		// returns the index of the neighbor of 'index' in the diagonal direction 'dir'
+		// or NO_NODE if the move is blocked, only the RunPlanner makes diagonal moves
+		// the move is blocked unless the node there is present and so are both nodes beside the move,
+		// except wall posts, since a diagonal cuts the corner of a cell and never reaches the post
+		int getDiagonalNeighborIndex( int index , direction dir ) const;
+
+		// fills 'path' after findPath has found the end node
+		// 'index' is the finish node in the path
 		// the path is created by working backwards from end node to start node
-		Path* createPath( const Node* node , bool isMapping = false , NodePairList* passageNodes = nullptr );
+		void createPath( int index , Path& path , bool isMapping = false , NodePairList* passageNodes = nullptr );
 
-		// populates 'maze' with Nodes
+		// populates the maze with Nodes
 		void initNodes();
 
-		// returns the Nodes in maze to their initial sates
+		// starts a new search epoch, which makes the search state of every node stale
+		// this is O(1) except when the epoch counter wraps
 		void resetNodes();
-		
-		// a 2D array of Nodes that represents the physical maze
-		Node* maze[ NUM_NODES_W ][ NUM_NODES_H ];
 
+		// returns the search state of the node at 'index' to its initial state
+		// if it was last written by an earlier search, must be called before reading it
+		void touchNode( int index );
+
+		// reads and writes one bit of a flag array indexed by node index
+		bool getFlag( const unsigned int* flags , int index ) const;
+		void setFlag( unsigned int* flags , int index , bool flag );
+
+		// the nodes that represent the physical maze, stored as a structure of arrays
+		// so a search only touches the arrays it uses and removing a node is a bit clear
+		static const int NUM_FLAG_WORDS = ( NUM_NODES + 31 ) / 32;
+
+		Board nodePresent; // set if the node exists, cleared by removeNode
+		Board nodeExplored; // set once the mouse has seen the node, only for present nodes
+		unsigned int nodeClosed[ NUM_FLAG_WORDS ]; // set once the search has expanded the node
+
+		unsigned short nodeG[ NUM_NODES ]; // movement cost from start
+		unsigned short nodeF[ NUM_NODES ]; // movement + heuristic cost, BIDIRECTIONAL keeps the cost to end here
+		unsigned short nodeParent[ NUM_NODES ]; // the index of the parent used for pathfinding, or NO_NODE
+		unsigned char nodeDir[ NUM_NODES ]; // the direction from the parent node to the node
+
+		// G, F, parent, direction and closed are only valid for the search that wrote them,
+		// a node whose stamp is not the current epoch is reset by touchNode() when it is first reached
+		unsigned short nodeStamp[ NUM_NODES ]; // the search epoch that last wrote the node
+		unsigned short searchEpoch;
+
+		// the open lists for every engine, kept between searches to avoid reallocating them
+		std::vector< int > sortedOpenList;
+		NodeHeap openHeap;
+
+		// the open list for BUCKET_QUEUE, it is only allocated once a search uses it
+		BucketQueue* openBuckets = nullptr;
+
+		// keeps the START to FINISH mapping search up to date as nodes are removed
+		IncrementalPlannerT< WIDTH , HEIGHT > incrementalPlanner;
+
+		// answers findRunPath, it borrows openHeap
+		// it is only allocated once findRunPath is used, and freed by reset()
+		RunPlannerT< WIDTH , HEIGHT >* runPlanner = nullptr;
+
+		// answers the queries over explored nodes, it borrows openHeap
+		CorridorGraphT< WIDTH , HEIGHT > corridorGraph;
+
+		// the dead ends of the explored nodes, which the CorridorGraph skips, and of the present nodes,
+		// whose deep dead ends the RunPlanner skips, since its diagonals may pass unexplored nodes
+		DeadEndPrunerT< WIDTH , HEIGHT > exploredPruner;
+		DeadEndPrunerT< WIDTH , HEIGHT > presentPruner;
+
+		// returns the nodes a search over explored nodes from 'start' to 'end' can skip,
+		// or nullptr if dead end pruning is disabled or 'start' or 'end' is in a dead end
+		// 'isRun' is for findRunPath, see exploredPruner and presentPruner
+		const Board* getSkippedNodes( PositionVector start , PositionVector end , bool isRun );
+
+		// answers getDistance, it is only allocated once it is used
+		DistanceTableT< WIDTH , HEIGHT >* distanceTable = nullptr;
+
+		// answers the flood queries, it is only allocated once setFloodGoal is used
+		ModifiedFloodFillT< WIDTH , HEIGHT >* floodFill = nullptr;
+
+		// runs the anytime search, it is only allocated once startAnytimeSearch is used
+		AnytimePlannerT< WIDTH , HEIGHT >* anytimePlanner = nullptr;
+
+		// the structures told about the changes to the nodes, in the order they were added,
+		// and whether each one is told about the nodes explored
+		NodeListener* listeners[ MAX_LISTENERS ];
+		bool listenerExplored[ MAX_LISTENERS ];
+		int numListeners = 0;
+
+		// the end node of the current search and its LOWER_BOUND table
+		int searchEndX = 0;
+		int searchEndY = 0;
+		const unsigned short* searchLowerBounds = nullptr;
+
+		// the kinds of query in the path cache, a run query is RUN_QUERY plus the direction the mouse faces
+		static const int EXPLORED_QUERY = 0 , MAPPING_QUERY = 1 , RUN_QUERY = 2;
+
+		// a path found at 'revision', an entry with revision 0 is unused
+		struct CachedPath
+		{
+			unsigned long revision = 0;
+			unsigned long lastUsed = 0; // cacheClock when it was last used, the oldest entry is replaced first
+			int start = 0; // the indices of the ends of the query
+			int end = 0;
+			int query = EXPLORED_QUERY;
+			bool found = false;
+			float runTime = 0.0f; // the predicted time of a run query
+			Path path;
+		};
+
+		// returns the cached answer to the query at the current revision, or nullptr if there is none
+		CachedPath* findCachedPath( PositionVector start , PositionVector end , int query );
+
+		// stores 'path' as the answer to the query at the current revision
+		void cachePath( PositionVector start , PositionVector end , int query , bool found , const Path& path , float runTime = 0.0f );
+
+		CachedPath cachedPaths[ NUM_CACHED_PATHS ];
+		unsigned long cacheClock = 0; // counts the uses of the cache, for CachedPath::lastUsed
+		float runPathTime = 0.0f; // the predicted time of the last run path, found or cached
+
+		// the cached LOWER_BOUND tables, the most recently used first
+		// enough for START, FINISH and one other end node during mapping
+		static const int NUM_LOWER_BOUND_TABLES = 3;
+		unsigned short* lowerBoundTables[ NUM_LOWER_BOUND_TABLES ];
+		int lowerBoundEnds[ NUM_LOWER_BOUND_TABLES ]; // the index of the end node for each table, -1 if unused
 	};
 
+	// the maze the mouse is built for
+	typedef MazeT< MAZE_W , MAZE_H > Maze;
+
 	//Prints out a picture of the maze for debugging.
 	//Just use: log( DEBUGX ) << maze;
 #ifdef __MK20DX256__ // Teensy Compile
 #else
-	std::ostream& operator<<(std::ostream& out, const Maze& maze);
+	template < int WIDTH , int HEIGHT >
+	std::ostream& operator<<(std::ostream& out, const MazeT< WIDTH , HEIGHT >& maze);
 #endif
 }
\ No newline at end of file
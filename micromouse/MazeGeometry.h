@@ -0,0 +1,63 @@
+#pragma once
+#include "Vector.h"
+
+
+
+namespace Micromouse
+{
+	// the cost of a node that has not been reached
+	const int INF = 65000;
+
+	// the cost of moving one node straight or diagonally
+	const int STRAIGHT_COST = 10, DIAGONAL_COST = 14;
+
+	// The sizes and lookup tables of a maze that is WIDTH cells wide and HEIGHT cells high.
+	// Everything is a compile time constant, so the classes templated on the maze size
+	// get their own copy of every loop with the bounds and offsets folded in.
+	//
+	// The nodes are the cells, the edges between cells and the posts between edges,
+	// a grid of ( 2W - 1 ) x ( 2H - 1 ). Vector.h has the same constants for the 16x16 maze.
+	template < int WIDTH , int HEIGHT >
+	struct MazeGeometry
+	{
+		static_assert( WIDTH > 1 && HEIGHT > 1 && WIDTH <= MAX_MAZE_W && HEIGHT <= MAX_MAZE_H , "the maze must fit in MAX_MAZE_W x MAX_MAZE_H" );
+
+		static const int MAZE_W = WIDTH , MAZE_H = HEIGHT;
+		static const int NUM_NODES_W = WIDTH * 2 - 1 , NUM_NODES_H = HEIGHT * 2 - 1;
+		static const int NUM_NODES = NUM_NODES_W * NUM_NODES_H;
+
+		// the highest cost any path through the maze can have, since a path visits every node at most once
+		static const int MAX_PATH_COST = DIAGONAL_COST * NUM_NODES;
+		static_assert( MAX_PATH_COST < INF , "every path cost must be below INF" );
+
+		// the most steps a path can have, when every node is its own step
+		// outside the center a path alternates between cells and the edges between them,
+		// so it has at most one more edge than cells, plus the posts in the center
+		static const int MAX_PATH_STEPS = 2 * WIDTH * HEIGHT + 4;
+
+		// the index of a node in the arrays of a maze
+		static constexpr int getIndex( int x , int y )
+		{
+			return x * NUM_NODES_H + y;
+		}
+
+		// returns true if ( x , y ) is inside the grid and is not a post,
+		// except for the posts inside the center, like Micromouse::isValidPosition()
+		static constexpr bool isValidPosition( int x , int y )
+		{
+			return x >= 0 && x < NUM_NODES_W && y >= 0 && y < NUM_NODES_H &&
+				( x % 2 == 0 || y % 2 == 0 || ( x >= WIDTH - 2 && y >= HEIGHT - 2 && x <= WIDTH && y <= HEIGHT ) );
+		}
+
+		// the change in x, y and index of one move in each direction, indexed by the direction enum
+		static constexpr int DX[ 8 ] = { 0 , 1 , 1 , 1 , 0 , -1 , -1 , -1 };
+		static constexpr int DY[ 8 ] = { 1 , 1 , 0 , -1 , -1 , -1 , 0 , 1 };
+		static constexpr int INDEX_OFFSET[ 8 ] = {
+			1 , NUM_NODES_H + 1 , NUM_NODES_H , NUM_NODES_H - 1 ,
+			-1 , -NUM_NODES_H - 1 , -NUM_NODES_H , -NUM_NODES_H + 1 };
+	};
+
+	template < int WIDTH , int HEIGHT > constexpr int MazeGeometry< WIDTH , HEIGHT >::DX[ 8 ];
+	template < int WIDTH , int HEIGHT > constexpr int MazeGeometry< WIDTH , HEIGHT >::DY[ 8 ];
+	template < int WIDTH , int HEIGHT > constexpr int MazeGeometry< WIDTH , HEIGHT >::INDEX_OFFSET[ 8 ];
+}
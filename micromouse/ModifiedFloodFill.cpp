@@ -0,0 +1,380 @@
+#include "ModifiedFloodFill.h"
+#include "Maze.h"
+#include <assert.h>
+
+
+
+
+namespace Micromouse
+{
+	// only straight moves are possible while mapping
+	static const direction floodDirections[] = { N , E , S , W };
+
+
+
+	template < int WIDTH , int HEIGHT >
+	ModifiedFloodFillT< WIDTH , HEIGHT >::ModifiedFloodFillT( const MazeT< WIDTH , HEIGHT >& maze ) :
+		maze( maze )
+	{
+		distances = new unsigned short[ Geometry::NUM_NODES ];
+		stack = new unsigned short[ Geometry::NUM_NODES ];
+
+		reset();
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	ModifiedFloodFillT< WIDTH , HEIGHT >::~ModifiedFloodFillT()
+	{
+		delete[] distances;
+		delete[] stack;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	void ModifiedFloodFillT< WIDTH , HEIGHT >::setGoal( PositionVector goal , unsigned long& nodesExpanded )
+	{
+		reset();
+
+		goalIndex = Geometry::getIndex( goal.x() , goal.y() );
+
+		if ( !maze.hasNode( goal ) )
+		{
+			return;
+		}
+
+		// a breadth first flood from the goal, with the stack used as the queue
+		int head = 0;
+		int tail = 0;
+
+		distances[ goalIndex ] = 0;
+		stack[ tail++ ] = goalIndex;
+
+		while ( head < tail )
+		{
+			int index = stack[ head++ ];
+			nodesExpanded++;
+
+			for ( int d = 0; d < 4; d++ )
+			{
+				int neighbor = maze.getNeighborIndex( index , floodDirections[ d ] );
+
+				if ( neighbor != MazeT< WIDTH , HEIGHT >::NO_NODE && distances[ neighbor ] == UNREACHED )
+				{
+					distances[ neighbor ] = distances[ index ] + 1;
+					stack[ tail++ ] = neighbor;
+				}
+			}
+		}
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	bool ModifiedFloodFillT< WIDTH , HEIGHT >::hasGoal() const
+	{
+		return goalIndex >= 0;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	void ModifiedFloodFillT< WIDTH , HEIGHT >::updateNode( PositionVector pos )
+	{
+		if ( !hasGoal() )
+		{
+			return;
+		}
+
+		int index = Geometry::getIndex( pos.x() , pos.y() );
+
+		// the node's own distance and the distances of the nodes that move through it can change
+		push( index );
+		pushNeighbors( index );
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	void ModifiedFloodFillT< WIDTH , HEIGHT >::update( unsigned long& nodesExpanded )
+	{
+		// first clear every node that lost the neighbor it reached the goal through. Raising it to one
+		// more than its neighbors instead would make the nodes behind a new wall raise each other a move
+		// at a time, and a part of the maze cut off from the goal would count up forever.
+		while ( stackSize > 0 )
+		{
+			int index = stack[ --stackSize ];
+			setBit( onStack , index , false );
+			setBit( touched , index , true );
+			nodesExpanded++;
+
+			if ( index == goalIndex || distances[ index ] == UNREACHED )
+			{
+				continue;
+			}
+
+			if ( maze.nodePresent.get( index / Geometry::NUM_NODES_H , index % Geometry::NUM_NODES_H ) && hasNearerNeighbor( index ) )
+			{
+				continue;
+			}
+
+			// only the neighbors one move further reached the goal through this node
+			unsigned short cleared = distances[ index ] + 1;
+			distances[ index ] = UNREACHED;
+
+			for ( int d = 0; d < 4; d++ )
+			{
+				int neighbor = index + Geometry::INDEX_OFFSET[ floodDirections[ d ] ];
+
+				if ( isNeighborInGrid( index , floodDirections[ d ] ) && distances[ neighbor ] == cleared )
+				{
+					push( neighbor );
+				}
+			}
+		}
+
+		// then lower the touched nodes from their neighbors, and the nodes they lower, in first in
+		// first out order so most nodes are only lowered once
+		int head = 0;
+		int tail = 0;
+		int queued = 0;
+
+		for ( int word = 0; word < BITS_WORDS; word++ )
+		{
+			while ( touched[ word ] != 0 )
+			{
+				int bit = BitBoardT< WIDTH , HEIGHT >::lowestBit( touched[ word ] );
+				int index = word * 32 + bit;
+				touched[ word ] &= touched[ word ] - 1;
+
+				if ( index == goalIndex || !maze.nodePresent.get( index / Geometry::NUM_NODES_H , index % Geometry::NUM_NODES_H ) )
+				{
+					continue;
+				}
+
+				unsigned short distance = getNearestNeighborDistance( index );
+
+				if ( distance != UNREACHED && distance + 1 < distances[ index ] )
+				{
+					distances[ index ] = distance + 1;
+					setBit( onStack , index , true );
+					stack[ tail ] = index;
+					tail = ( tail + 1 ) % Geometry::NUM_NODES;
+					queued++;
+				}
+			}
+		}
+
+		while ( queued > 0 )
+		{
+			int index = stack[ head ];
+			head = ( head + 1 ) % Geometry::NUM_NODES;
+			queued--;
+			setBit( onStack , index , false );
+			nodesExpanded++;
+
+			for ( int d = 0; d < 4; d++ )
+			{
+				int neighbor = maze.getNeighborIndex( index , floodDirections[ d ] );
+
+				if ( neighbor != MazeT< WIDTH , HEIGHT >::NO_NODE && distances[ index ] + 1 < distances[ neighbor ] )
+				{
+					distances[ neighbor ] = distances[ index ] + 1;
+
+					if ( !getBit( onStack , neighbor ) )
+					{
+						setBit( onStack , neighbor , true );
+						stack[ tail ] = neighbor;
+						tail = ( tail + 1 ) % Geometry::NUM_NODES;
+						queued++;
+					}
+				}
+			}
+		}
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	int ModifiedFloodFillT< WIDTH , HEIGHT >::getDistance( PositionVector pos ) const
+	{
+		if ( !hasGoal() || !maze.hasNode( pos ) )
+		{
+			return -1;
+		}
+
+		unsigned short distance = distances[ Geometry::getIndex( pos.x() , pos.y() ) ];
+
+		return distance == UNREACHED ? -1 : distance;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	direction ModifiedFloodFillT< WIDTH , HEIGHT >::getDirection( PositionVector pos , direction facing ) const
+	{
+		int distance = getDistance( pos );
+
+		if ( distance <= 0 )
+		{
+			return NONE;
+		}
+
+		int index = Geometry::getIndex( pos.x() , pos.y() );
+		direction nearer = NONE;
+
+		for ( int d = 0; d < 4; d++ )
+		{
+			int neighbor = maze.getNeighborIndex( index , floodDirections[ d ] );
+
+			if ( neighbor != MazeT< WIDTH , HEIGHT >::NO_NODE && distances[ neighbor ] == distance - 1 )
+			{
+				// going straight saves a turn
+				if ( floodDirections[ d ] == facing )
+				{
+					return facing;
+				}
+
+				if ( nearer == NONE )
+				{
+					nearer = floodDirections[ d ];
+				}
+			}
+		}
+
+		assert( nearer != NONE ); // every node with a distance has a neighbor one move nearer once update() ran
+
+		return nearer;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	void ModifiedFloodFillT< WIDTH , HEIGHT >::reset()
+	{
+		goalIndex = -1;
+		stackSize = 0;
+
+		for ( int i = 0; i < Geometry::NUM_NODES; i++ )
+		{
+			distances[ i ] = UNREACHED;
+		}
+
+		for ( int i = 0; i < BITS_WORDS; i++ )
+		{
+			onStack[ i ] = 0;
+			touched[ i ] = 0;
+		}
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	void ModifiedFloodFillT< WIDTH , HEIGHT >::push( int index )
+	{
+		if ( !getBit( onStack , index ) )
+		{
+			setBit( onStack , index , true );
+			stack[ stackSize++ ] = index;
+		}
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	void ModifiedFloodFillT< WIDTH , HEIGHT >::pushNeighbors( int index )
+	{
+		for ( int d = 0; d < 4; d++ )
+		{
+			// a removed neighbor still has a distance to clear
+			if ( isNeighborInGrid( index , floodDirections[ d ] ) )
+			{
+				push( index + Geometry::INDEX_OFFSET[ floodDirections[ d ] ] );
+			}
+		}
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	bool ModifiedFloodFillT< WIDTH , HEIGHT >::isNeighborInGrid( int index , direction dir )
+	{
+		int x = index / Geometry::NUM_NODES_H;
+		int y = index % Geometry::NUM_NODES_H;
+
+		return Geometry::isValidPosition( x + Geometry::DX[ dir ] , y + Geometry::DY[ dir ] );
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	bool ModifiedFloodFillT< WIDTH , HEIGHT >::hasNearerNeighbor( int index ) const
+	{
+		for ( int d = 0; d < 4; d++ )
+		{
+			int neighbor = maze.getNeighborIndex( index , floodDirections[ d ] );
+
+			if ( neighbor != MazeT< WIDTH , HEIGHT >::NO_NODE && distances[ neighbor ] + 1 == distances[ index ] )
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	unsigned short ModifiedFloodFillT< WIDTH , HEIGHT >::getNearestNeighborDistance( int index ) const
+	{
+		unsigned short distance = UNREACHED;
+
+		for ( int d = 0; d < 4; d++ )
+		{
+			int neighbor = maze.getNeighborIndex( index , floodDirections[ d ] );
+
+			if ( neighbor != MazeT< WIDTH , HEIGHT >::NO_NODE && distances[ neighbor ] < distance )
+			{
+				distance = distances[ neighbor ];
+			}
+		}
+
+		return distance;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	bool ModifiedFloodFillT< WIDTH , HEIGHT >::getBit( const unsigned int* bits , int index )
+	{
+		return ( bits[ index / 32 ] >> ( index % 32 ) & 1 ) != 0;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	void ModifiedFloodFillT< WIDTH , HEIGHT >::setBit( unsigned int* bits , int index , bool flag )
+	{
+		if ( flag )
+		{
+			bits[ index / 32 ] |= 1u << ( index % 32 );
+		}
+		else
+		{
+			bits[ index / 32 ] &= ~( 1u << ( index % 32 ) );
+		}
+	}
+
+
+
+	// the classic and the half size competition mazes, only the simulator builds the half size one
+	template class ModifiedFloodFillT< 16 , 16 >;
+
+#ifdef __MK20DX256__ // Teensy Compile
+#else // PC compile
+	template class ModifiedFloodFillT< 32 , 32 >;
+#endif
+}
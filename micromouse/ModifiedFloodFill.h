@@ -0,0 +1,103 @@
+#pragma once
+#include "Vector.h"
+#include "NodeListener.h"
+#include "MazeGeometry.h"
+
+
+
+namespace Micromouse
+{
+	template < int WIDTH , int HEIGHT > class MazeT;
+
+	// The classic micromouse modified flood fill, for a mouse that explores by always
+	// moving to the neighbor nearest the goal.
+	//
+	// Every node keeps its number of moves to the goal, with the unexplored nodes treated as
+	// open, like Maze::findPath does while mapping. A node is consistent when its distance is
+	// one more than the lowest distance of its neighbors. Finding a wall only changes the nodes
+	// around it, so updateNode() pushes them on a stack and update() only fixes them and the nodes
+	// their change reaches. Each step of exploration does the work for the walls it found,
+	// instead of a search from START.
+	//
+	// The classic fix raises a node to one more than its neighbors, so the nodes behind a new wall
+	// raise each other a move at a time, and a part of the maze cut off from the goal counts up
+	// forever. update() instead clears the nodes that lost the neighbor they reached the goal
+	// through, then lowers the cleared nodes again from the nodes around them.
+	// The distances and the stack take 4 bytes per node, 3.8 KB for the 16x16 maze.
+	// The maze calls updateNode() whenever a node is added or removed, see NodeListener.
+	template < int WIDTH , int HEIGHT >
+	class ModifiedFloodFillT : public NodeListener
+	{
+	public:
+		typedef MazeGeometry< WIDTH , HEIGHT > Geometry;
+
+		ModifiedFloodFillT( const MazeT< WIDTH , HEIGHT >& maze );
+		~ModifiedFloodFillT();
+
+		// sets the distance of every node to the moves from it to 'goal'
+		// 'nodesExpanded' is increased by the number of nodes flooded
+		void setGoal( PositionVector goal , unsigned long& nodesExpanded );
+
+		// returns true if setGoal was called since the last reset()
+		bool hasGoal() const;
+
+		// must be called after the node at 'pos' was added or removed from the maze
+		void updateNode( PositionVector pos );
+
+		// fixes the distances of the nodes on the stack and the nodes they change
+		// 'nodesExpanded' is increased by the number of nodes checked and lowered
+		void update( unsigned long& nodesExpanded );
+
+		// returns the number of moves from 'pos' to the goal, or -1 if it cannot reach the goal
+		int getDistance( PositionVector pos ) const;
+
+		// returns the direction of a move from 'pos' that is one move nearer the goal, 'facing' if it is one,
+		// or NONE if 'pos' is the goal or cannot reach it
+		direction getDirection( PositionVector pos , direction facing ) const;
+
+		// forgets the goal and every distance
+		void reset();
+
+	private:
+		// the distance of a node that cannot reach the goal
+		static const unsigned short UNREACHED = 0xFFFF;
+
+		// pushes the node at 'index' on the stack if it is not on it
+		void push( int index );
+
+		// pushes every neighbor of the node at 'index' that is a valid position, even the removed ones
+		void pushNeighbors( int index );
+
+		// returns true if the neighbor of the node at 'index' in the direction 'dir' is a valid position
+		static bool isNeighborInGrid( int index , direction dir );
+
+		// returns true if the node at 'index' can move to a neighbor one move nearer the goal
+		bool hasNearerNeighbor( int index ) const;
+
+		// returns the lowest distance of the neighbors the node at 'index' can move to
+		unsigned short getNearestNeighborDistance( int index ) const;
+
+		// reads and writes the bit of the node at 'index' in 'bits', a bit per node
+		static bool getBit( const unsigned int* bits , int index );
+		static void setBit( unsigned int* bits , int index , bool flag );
+
+		static const int BITS_WORDS = ( Geometry::NUM_NODES + 31 ) / 32;
+
+		const MazeT< WIDTH , HEIGHT >& maze;
+
+		int goalIndex = -1;
+
+		unsigned short* distances; // distances[ index ] is the moves from the node to the goal
+		unsigned short* stack; // the inconsistent nodes, also the queue of setGoal's flood and of the lowering
+		int stackSize = 0;
+
+		// a bit for each node, set while it is on the stack or the queue
+		unsigned int onStack[ BITS_WORDS ];
+
+		// a bit for each node checked since the last lowering
+		unsigned int touched[ BITS_WORDS ];
+	};
+
+	// the flood fill for the maze size the mouse is built for
+	typedef ModifiedFloodFillT< MAZE_W , MAZE_H > ModifiedFloodFill;
+}
@@ -0,0 +1,213 @@
+#include "MotionCompiler.h"
+#include <math.h>
+#include <stdlib.h>
+#include <assert.h>
+
+
+
+
+namespace Micromouse
+{
+	const float PI_F = 3.141592f;
+
+	// returns the number of 45 degree steps in the rotation 'turn', turning either way
+	static int getTurnSteps( direction turn )
+	{
+		return turn <= S ? turn : 8 - turn;
+	}
+
+
+
+	MotionCompiler::MotionCompiler( const Path& path , direction facing , const MotionModel& model ) :
+		path( path ),
+		facing( facing ),
+		model( model )
+	{
+		int numSteps = path.size();
+
+		// decide which turns are swept, each cuts a corner from the straights on both sides
+		// and a straight needs some length left after both of its corners are cut
+		float cutBefore = 0.0f;
+
+		for ( int i = 0; i < numSteps; i++ )
+		{
+			junctionSpeed[ i ] = 0.0f;
+
+			if ( i + 1 < numSteps && model.sweptTurnSpeed > 0.0f )
+			{
+				direction turn = path.getStep( i + 1 ).dir() - path.getStep( i ).dir();
+				int turnSteps = getTurnSteps( turn );
+
+				if ( turnSteps == 1 || turnSteps == 2 )
+				{
+					float cut = getCornerCut( turn );
+
+					if ( getStepLength( i ) - cutBefore > cut && getStepLength( i + 1 ) > cut )
+					{
+						junctionSpeed[ i ] = model.sweptTurnSpeed;
+						cutBefore = cut;
+						continue;
+					}
+				}
+			}
+
+			cutBefore = 0.0f;
+		}
+
+		// lower the speeds a straight could not brake from to the speed after it, then the ones
+		// it could not reach from the speed before it, which never breaks the first limit
+		// every straight is longer than its cut corners, so a swept turn never drops to 0
+		for ( int i = numSteps - 1; i > 0; i-- )
+		{
+			float length = getStepLength( i ) - getCutAfter( i - 1 ) - getCutAfter( i );
+
+			junctionSpeed[ i - 1 ] = fminf( junctionSpeed[ i - 1 ] , sqrtf( junctionSpeed[ i ] * junctionSpeed[ i ] + 2.0f * model.acceleration * length ) );
+		}
+
+		float entrySpeed = 0.0f;
+
+		for ( int i = 0; i < numSteps; i++ )
+		{
+			float length = getStepLength( i ) - ( i > 0 ? getCutAfter( i - 1 ) : 0.0f ) - getCutAfter( i );
+
+			junctionSpeed[ i ] = fminf( junctionSpeed[ i ] , sqrtf( entrySpeed * entrySpeed + 2.0f * model.acceleration * length ) );
+			entrySpeed = junctionSpeed[ i ];
+		}
+	}
+
+
+
+	bool MotionCompiler::next( MotionPrimitive& primitive )
+	{
+		return getPrimitive( cursor , primitive );
+	}
+
+
+
+	float MotionCompiler::getTime() const
+	{
+		float seconds = 0.0f;
+
+		int primitiveCursor = 0;
+		MotionPrimitive primitive;
+
+		while ( getPrimitive( primitiveCursor , primitive ) )
+		{
+			seconds += getTime( primitive );
+		}
+
+		return seconds;
+	}
+
+
+
+	float MotionCompiler::getTime( const MotionPrimitive& primitive ) const
+	{
+		switch ( primitive.type )
+		{
+		case MotionPrimitive::TURN_IN_PLACE:
+			return model.getTurnTime( static_cast< direction >( abs( primitive.degrees ) / 45 ) );
+
+		case MotionPrimitive::SWEPT_TURN:
+			return primitive.distance / primitive.entrySpeed;
+
+		case MotionPrimitive::STRAIGHT:
+		case MotionPrimitive::DIAGONAL:
+		default:
+			return model.getDriveTime( primitive.distance , primitive.entrySpeed , primitive.exitSpeed ) +
+				( primitive.exitSpeed == 0.0f ? model.straightDelay : 0.0f );
+		}
+	}
+
+
+
+	bool MotionCompiler::getPrimitive( int& cursor , MotionPrimitive& primitive ) const
+	{
+		while ( cursor < 2 * path.size() )
+		{
+			int i = cursor / 2;
+			bool isStraight = cursor % 2 != 0;
+			cursor++;
+
+			DirectionVector step = path.getStep( i );
+
+			primitive = MotionPrimitive();
+			primitive.heading = step.dir();
+
+			if ( isStraight )
+			{
+				primitive.type = step.dir() % 2 == 0 ? MotionPrimitive::STRAIGHT : MotionPrimitive::DIAGONAL;
+				primitive.numNodes = step.mag();
+				primitive.distance = getStepLength( i ) - ( i > 0 ? getCutAfter( i - 1 ) : 0.0f ) - getCutAfter( i );
+				primitive.entrySpeed = i > 0 ? junctionSpeed[ i - 1 ] : 0.0f;
+				primitive.exitSpeed = junctionSpeed[ i ];
+
+				return true;
+			}
+
+			direction previous = i > 0 ? path.getStep( i - 1 ).dir() : facing;
+			direction turn = step.dir() - previous;
+
+			if ( turn == N )
+			{
+				continue; // already facing the straight
+			}
+
+			primitive.degrees = getDegrees( turn );
+
+			if ( i > 0 && junctionSpeed[ i - 1 ] > 0.0f )
+			{
+				primitive.type = MotionPrimitive::SWEPT_TURN;
+				primitive.distance = model.turnRadius * abs( primitive.degrees ) * PI_F / 180.0f;
+				primitive.entrySpeed = junctionSpeed[ i - 1 ];
+				primitive.exitSpeed = junctionSpeed[ i - 1 ];
+			}
+			else
+			{
+				primitive.type = MotionPrimitive::TURN_IN_PLACE;
+			}
+
+			return true;
+		}
+
+		return false;
+	}
+
+
+
+	float MotionCompiler::getStepLength( int i ) const
+	{
+		DirectionVector step = path.getStep( i );
+
+		return step.mag() * MM_PER_NODE * ( step.dir() % 2 == 0 ? 1.0f : SQRT_OF_TWO );
+	}
+
+
+
+	float MotionCompiler::getCornerCut( direction turn ) const
+	{
+		// the arc meets each straight where the tangents from the corner touch the circle
+		float radians = getTurnSteps( turn ) * PI_F / 4.0f;
+
+		return model.turnRadius * tanf( radians / 2.0f );
+	}
+
+
+
+	float MotionCompiler::getCutAfter( int i ) const
+	{
+		if ( junctionSpeed[ i ] == 0.0f )
+		{
+			return 0.0f;
+		}
+
+		return getCornerCut( path.getStep( i + 1 ).dir() - path.getStep( i ).dir() );
+	}
+
+
+
+	int MotionCompiler::getDegrees( direction turn )
+	{
+		return turn <= S ? 45 * turn : 45 * turn - 360;
+	}
+}
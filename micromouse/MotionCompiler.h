@@ -0,0 +1,82 @@
+#pragma once
+#include "Vector.h"
+#include "Path.h"
+#include "MotionModel.h"
+
+
+
+namespace Micromouse
+{
+	// one motion of the mouse, made by MotionCompiler and driven by RobotIO::execute()
+	struct MotionPrimitive
+	{
+		// STRAIGHT and DIAGONAL drive 'distance' mm along 'heading'
+		// TURN_IN_PLACE rotates by 'degrees' while stopped
+		// SWEPT_TURN rotates by 'degrees' along an arc 'distance' mm long without stopping
+		enum Type { STRAIGHT , DIAGONAL , TURN_IN_PLACE , SWEPT_TURN };
+
+		Type type = STRAIGHT;
+		direction heading = N; // the direction the mouse faces when the primitive is done
+		int numNodes = 0; // the nodes the mouse moves forward, only the straights move it
+		int degrees = 0; // positive turns to the right, like RobotIO::rotate
+		float distance = 0.0f; // mm
+		float entrySpeed = 0.0f; // mm per second at the start
+		float exitSpeed = 0.0f; // mm per second at the end
+	};
+
+
+
+	// Compiles a Path into the stream of MotionPrimitives that drives it, so the steps
+	// can flow into each other instead of the mouse stopping after every one.
+	//
+	// A 45 or 90 degree turn between two straights is swept along an arc when both straights
+	// are long enough for the corner the arc cuts, every other turn is made in place.
+	// The speed through a swept turn is the MotionModel's sweptTurnSpeed, lowered where a
+	// straight is too short to speed up to it or to brake from it at the model's acceleration.
+	//
+	// The path is read without being changed and must outlive the compiler.
+	class MotionCompiler
+	{
+	public:
+		// compiles 'path' for a mouse that starts stopped and facing 'facing'
+		MotionCompiler( const Path& path , direction facing , const MotionModel& model );
+
+		// writes the next primitive into 'primitive'
+		// returns false once every primitive has been returned
+		bool next( MotionPrimitive& primitive );
+
+		// returns the predicted seconds to drive every primitive, including the delays after stopping
+		float getTime() const;
+
+		// returns the predicted seconds to drive 'primitive', including the delay after it if it stops
+		float getTime( const MotionPrimitive& primitive ) const;
+
+	private:
+		// writes the primitive at 'cursor' into 'primitive' and moves 'cursor' past it
+		// 'cursor' counts two for every step, the turn into the step and then its straight
+		// returns false if there are no primitives left
+		bool getPrimitive( int& cursor , MotionPrimitive& primitive ) const;
+
+		// returns the length of step 'i' in mm, before the swept turns cut its corners
+		float getStepLength( int i ) const;
+
+		// returns the mm a swept turn by 'turn' cuts from the straight on each side
+		float getCornerCut( direction turn ) const;
+
+		// returns the mm cut from the end of step 'i' by the turn after it
+		float getCutAfter( int i ) const;
+
+		// returns 'turn' in degrees, positive to the right
+		static int getDegrees( direction turn );
+
+		const Path& path;
+		direction facing;
+		MotionModel model;
+
+		int cursor = 0;
+
+		// junctionSpeed[ i ] is the speed between step i and the next one
+		// 0 when the mouse stops there and turns in place, and after the last step
+		float junctionSpeed[ Path::MAX_STEPS ];
+	};
+}
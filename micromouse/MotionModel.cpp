@@ -0,0 +1,60 @@
+#include "MotionModel.h"
+#include <math.h>
+#include <assert.h>
+
+
+
+namespace Micromouse
+{
+	float MotionModel::getStraightTime( int numNodes , bool diagonal ) const
+	{
+		assert( numNodes >= 0 );
+
+		if ( numNodes == 0 )
+		{
+			return 0.0f;
+		}
+
+		float distance = numNodes * MM_PER_NODE;
+
+		if ( diagonal )
+		{
+			distance *= SQRT_OF_TWO;
+		}
+
+		return getDriveTime( distance , 0.0f , 0.0f ) + straightDelay;
+	}
+
+
+
+	float MotionModel::getDriveTime( float distance , float entrySpeed , float exitSpeed ) const
+	{
+		// the speed reached where speeding up from the entry speed meets braking to the exit speed
+		float peakSpeed = sqrtf( ( 2.0f * acceleration * distance + entrySpeed * entrySpeed + exitSpeed * exitSpeed ) / 2.0f );
+		peakSpeed = fminf( peakSpeed , maxSpeed );
+		peakSpeed = fmaxf( peakSpeed , fmaxf( entrySpeed , exitSpeed ) );
+
+		if ( peakSpeed <= 0.0f )
+		{
+			return 0.0f;
+		}
+
+		float rampUpDistance = ( peakSpeed * peakSpeed - entrySpeed * entrySpeed ) / ( 2.0f * acceleration );
+		float rampDownDistance = ( peakSpeed * peakSpeed - exitSpeed * exitSpeed ) / ( 2.0f * acceleration );
+		float cruiseDistance = fmaxf( distance - rampUpDistance - rampDownDistance , 0.0f );
+
+		return ( peakSpeed - entrySpeed ) / acceleration + ( peakSpeed - exitSpeed ) / acceleration + cruiseDistance / peakSpeed;
+	}
+
+
+
+	float MotionModel::getTurnTime( direction turn ) const
+	{
+		assert( turn != NONE );
+
+		// the number of 45 degree steps, turning either way
+		int steps = turn <= S ? turn : 8 - turn;
+
+		return steps * turnTime + turnDelay;
+	}
+}
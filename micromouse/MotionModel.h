@@ -0,0 +1,48 @@
+#pragma once
+#include "Vector.h"
+
+
+
+namespace Micromouse
+{
+	// the distance between the centers of two neighboring nodes, half of a cell
+	const float MM_PER_NODE = 90.0f;
+
+	// how much longer a diagonal move is than a straight one
+	const float SQRT_OF_TWO = 1.414213f;
+
+	// Predicts how long the mouse takes to drive and rotate, so a run can be planned
+	// for the lowest time instead of the fewest nodes.
+	//
+	// A straight speeds up to maxSpeed, cruises and brakes at the same rate, or only speeds up
+	// and brakes if it is too short to reach maxSpeed. Straights that start and end stopped,
+	// like MouseBot::moveForward, and rotations in place, which take turnTime for every
+	// 45 degrees, are followed by the delays in MouseBot.
+	//
+	// The defaults are rough values for the current mouse, measured ones should replace them
+	struct MotionModel
+	{
+		float maxSpeed = 300.0f; // mm per second
+		float acceleration = 600.0f; // mm per second squared, both speeding up and braking
+		float straightDelay = 0.5f; // seconds waited after every straight
+		float turnTime = 0.15f; // seconds to rotate 45 degrees
+		float turnDelay = 0.2f; // seconds waited after every rotation, even one by N
+
+		// 45 and 90 degree turns between straights can be swept along an arc without stopping
+		// see MotionCompiler, a sweptTurnSpeed of 0 always stops and turns in place
+		float sweptTurnSpeed = 250.0f; // mm per second along the arc
+		float turnRadius = MM_PER_NODE; // mm
+
+		// returns the seconds to drive 'distance' mm starting at 'entrySpeed' and ending at 'exitSpeed'
+		// without any delay, the distance must be long enough to change between the two speeds
+		float getDriveTime( float distance , float entrySpeed , float exitSpeed ) const;
+
+		// returns the seconds to drive 'numNodes' nodes straight from a stop to a stop, including straightDelay
+		// a 'diagonal' move between nodes is SQRT_OF_TWO times as long, like MouseBot::moveForward
+		float getStraightTime( int numNodes , bool diagonal = false ) const;
+
+		// returns the seconds to rotate by 'turn' relative to the current facing, including turnDelay
+		// N is no rotation and only costs turnDelay, since MouseBot::rotate always waits
+		float getTurnTime( direction turn ) const;
+	};
+}
@@ -11,12 +11,16 @@ Author GitHub:	joshuasrjc
 #include "Logger.h"
 #include "ButtonFlag.h"
 
+#ifdef __MK20DX256__ // Teensy Compile
+#else // PC compile
+	#include <chrono>
+	#include <thread>
+#endif
+
 
 
 namespace Micromouse
 {
-#define SQRT_OF_TWO (1.414213f)
-
 	/**** CONSTRUCTORS ****/
 
 	MouseBot::MouseBot(int x, int y)
@@ -26,6 +30,9 @@ namespace Micromouse
 		setPos(x, y);
 		maze = new Maze();
 
+		// a path never has more passages than half its steps
+		nodePairList.reserve(Path::MAX_STEPS / 2 + 1);
+
 #ifdef __MK20DX256__ // Teensy Compile
 #else
 		// If compiled for PC
@@ -46,6 +53,7 @@ namespace Micromouse
 #ifdef __MK20DX256__ // Teensy Compile
 #else // PC compile
 		delete virtualMaze;
+		delete plannerThread;
 #endif
 	}
 
@@ -81,6 +89,11 @@ namespace Micromouse
 		facing = N;
 	}
 
+	Maze& MouseBot::getMaze()
+	{
+		return *maze;
+	}
+
 
 
 
@@ -93,13 +106,12 @@ namespace Micromouse
 		
 		moves = 0; // Reset moves made to zero
 
-		Path* path;	// Used for pathfinding	
-		NodePairList nodePairList; // Vector of node pairs;
+		nodePairList.clear();
 		bool foundFinish = false; // If the maze finish has been found
 
 		// Set the starting and finish node as explored
-		maze->getNode(PositionVector::START)->setExplored();
-		maze->getNode(PositionVector::FINISH)->setExplored();
+		maze->setExplored(PositionVector::START);
+		maze->setExplored(PositionVector::FINISH);
 		
 		for (;;)
 		{
@@ -107,22 +119,27 @@ namespace Micromouse
 
 			// Find a path from start to finish generating a NodePair for 
 			// everytime the path goes into unexplored nodes
-			path = maze->findPath(PositionVector::START, PositionVector::FINISH, true, &nodePairList);
-			delete path;
+			maze->findPath(PositionVector::START, PositionVector::FINISH, path, true, &nodePairList);
+
+			log(DEBUG3) << "START to FINISH expanded " << maze->getSearchStats().lastNodesExpanded << " nodes";
 			
 			// If the shortest path was completely contained within explored nodes
 			// then no NodePairs were created and we can stop mapping
 			if (nodePairList.size() == 0) break; 
 
+			// Or the known path is already close enough to it
+			if (isWithinMappingGap(path)) break;
+
 			// Otherwise we do not have the shortest path fully explored
-			// So we find the closest node at the boundry between explored and 
-			// unexplored nodes
-			NodePair closestNodePair = getClosestNodePair(nodePairList);
+			// So the exploration policy picks a node at the boundry between explored
+			// and unexplored nodes, and we travel to it by only pathfinding on explored
+			// nodes to guarantee we can get there safely. By default it is the closest one
+			NodePair closestNodePair = nodePairList.front();
+			if (!explorationPolicy->selectPassage(*maze, position, path, nodePairList, path, closestNodePair))
+			{
+				log(ERROR) << "COULD NOT FIND PATH DURING RUNNING";
+			}
 			nodePairList.clear();
-
-			// Travel to the nearest node we just found by only pathfinding on
-			// explored nodes to guarantee we can get there safely
-			path = maze->findPath(position, closestNodePair.first->getPos() );
 			followPath(path);
 
 			for (;;)
@@ -131,26 +148,34 @@ namespace Micromouse
 
 				// Attempt to travel from the first node of the pair to the second
 				// Stop if the path is blocked
-				path = maze->findPath(position, closestNodePair.second->getPos(), true);
-				followPathUntilBroken(path);
+				if (!maze->findPath(position, closestNodePair.second, path, true))
+				{
+					log(ERROR) << "COULD NOT FIND PATH DURING MAPPING";
+				}
+				// Follow it, then find a new path from start to finish incase it was
+				// changed by the recently discovered walls
+				followPathAndReplan(path);
 
-				// Find a new path from start to finish incase it was changed by
-				// the recently discovered walls
-				path = maze->findPath(PositionVector::START, PositionVector::FINISH, true, &nodePairList);
-				delete path;
+				log(DEBUG3) << "START to FINISH expanded " << maze->getSearchStats().lastNodesExpanded << " nodes";
 
 				// If the shortest path was completely contained within explored nodes
 				// then no NodePairs were created and we can stop mapping
 				if (nodePairList.size() == 0) goto FINISH_MAPPING;
 
+				// Or the known path is already close enough to it
+				if (isWithinMappingGap(path)) goto FINISH_MAPPING;
+
 				// If we are at the second node of the pair
-				if (position == closestNodePair.second->getPos()) break;
+				if (position == closestNodePair.second) break;
+
+				// Or the policy would rather choose again for the new path
+				if (!explorationPolicy->keepPassage(*maze, position, path, closestNodePair)) break;
 			}
 
-			// The first time this line is reached is when we are at the 
-			// finish of the maze. We can then remove all remaining nodes 
-			// around the center because we know they must be walls
-			if (!foundFinish)
+			// The first time we stop at the finish of the maze we can
+			// remove all remaining nodes around the center because we
+			// know they must be walls
+			if (!foundFinish && position == PositionVector::FINISH)
 			{
 				maze->removeExcessFinshNodes();
 				foundFinish = true;
@@ -162,7 +187,81 @@ namespace Micromouse
 		// exit point for the inner loop
 		FINISH_MAPPING:
 
-		logC(INFO) << "Mapped maze in: " << moves << " moves";
+		// the number of moves is logged by the caller, so mapping itself never allocates
+		log(DEBUG2) << "Searches: " << maze->getSearchStats().searches
+			<< ", nodes expanded: " << maze->getSearchStats().nodesExpanded
+			<< ", most in one search: " << maze->getSearchStats().maxNodesExpanded;
+
+		returnToStart();
+
+		BUTTONEXIT
+		return moves;
+	}
+
+
+
+	int MouseBot::mapMazeFloodFill()
+	{
+		log(DEBUG1) << "Mapping Maze with the modified flood fill...";
+
+		moves = 0; // Reset moves made to zero
+
+		bool foundFinish = false; // If the maze finish has been found
+
+		// Set the starting and finish node as explored
+		maze->setExplored(PositionVector::START);
+		maze->setExplored(PositionVector::FINISH);
+
+		bool toFinish = true; // the flood goal is FINISH, or START on the way back
+		maze->setFloodGoal(PositionVector::FINISH);
+
+		for (;;)
+		{
+			BUTTONFLAG // Used to abort operation if button is pressed
+
+			// the walls found here are pushed on the flood fill's stack by the maze
+			lookAround();
+
+			if (position == (toFinish ? PositionVector::FINISH : PositionVector::START))
+			{
+				// The first time the finish is reached the remaining nodes
+				// around the center must be walls
+				if (!foundFinish)
+				{
+					maze->removeExcessFinshNodes();
+					foundFinish = true;
+				}
+
+				// Every trip follows a shortest path with the unexplored nodes counted as open,
+				// so once the explored nodes have a path that short no unexplored node can shorten it
+				maze->findPath(PositionVector::START, PositionVector::FINISH, path, true);
+				int mappingMoves = getPathMoves(path);
+
+				if (maze->findPath(PositionVector::START, PositionVector::FINISH, path) && getPathMoves(path) == mappingMoves)
+				{
+					break;
+				}
+
+				toFinish = !toFinish;
+				maze->setFloodGoal(toFinish ? PositionVector::FINISH : PositionVector::START);
+				continue;
+			}
+
+			direction dir = maze->getFloodDirection(position, facing);
+
+			if (dir == NONE)
+			{
+				log(ERROR) << "COULD NOT FIND PATH DURING MAPPING";
+				break;
+			}
+
+			rotateToFaceDirection(dir);
+			moveForward();
+		}
+
+		log(DEBUG2) << "Searches: " << maze->getSearchStats().searches
+			<< ", nodes expanded: " << maze->getSearchStats().nodesExpanded
+			<< ", most in one search: " << maze->getSearchStats().maxNodesExpanded;
 
 		returnToStart();
 
@@ -172,12 +271,30 @@ namespace Micromouse
 
 
 
+	void MouseBot::setExplorationPolicy(ExplorationPolicy* policy)
+	{
+		explorationPolicy = policy != nullptr ? policy : &nearestPassagePolicy;
+	}
+
+
+
+	void MouseBot::setMappingGap(float gap)
+	{
+		mappingGap = gap;
+	}
+
+
+
 	void MouseBot::runMaze()
 	{
 		log(DEBUG1) << "Run Maze";
 
-		Path* pathCenter = maze->findPath(position, PositionVector::FINISH);
-		followPath(pathCenter);
+		// plan for the lowest predicted time, not the fewest nodes
+		if (!maze->findRunPath(position, facing, PositionVector::FINISH, path))
+		{
+			log(ERROR) << "COULD NOT FIND PATH DURING RUNNING";
+		}
+		runPath(path);
 
 		returnToStart();
 	}
@@ -186,8 +303,7 @@ namespace Micromouse
 
 	void MouseBot::resetMaze()
 	{
-		delete maze;
-		maze = new Maze();
+		maze->reset();
 	}
 
 
@@ -197,13 +313,79 @@ namespace Micromouse
 #ifdef __MK20DX256__ // Teensy Compile
 		delay(400);
 #endif
-		Path* pathHome = maze->findPath(position, PositionVector::START);
-		followPath(pathHome);
+		if (!maze->findPath(position, PositionVector::START, path))
+		{
+			log(ERROR) << "COULD NOT FIND PATH DURING RUNNING";
+		}
+		followPath(path);
 		rotate(S);
 	}
 
 
 
+	void MouseBot::followPathAndReplan(Path& path)
+	{
+#ifdef __MK20DX256__ // Teensy Compile
+		followPathUntilBroken(path);
+		maze->findPath(PositionVector::START, PositionVector::FINISH, path, true, &nodePairList);
+#else // PC compile
+		// with instant moves the worker could never plan before the mouse stops, so it is not started
+		if (plannerThread == nullptr || motionTimeScale <= 0.0f)
+		{
+			followPathUntilBroken(path);
+			maze->findPath(PositionVector::START, PositionVector::FINISH, path, true, &nodePairList);
+			return;
+		}
+
+		// the worker plans for the walls the mouse may find while it drives the path
+		plannerThread->plan(*maze, position, path);
+		followPathUntilBroken(path);
+
+		if (!plannerThread->takePlan(*maze, path, nodePairList))
+		{
+			maze->findPath(PositionVector::START, PositionVector::FINISH, path, true, &nodePairList);
+		}
+#endif
+	}
+
+
+
+	int MouseBot::getPathMoves(const Path& path)
+	{
+		int numMoves = 0;
+
+		for (int i = 0; i < path.size(); i++)
+		{
+			numMoves += path.getStep(i).mag();
+		}
+
+		return numMoves;
+	}
+
+
+
+	bool MouseBot::isWithinMappingGap(const Path& mappingPath)
+	{
+		if (mappingGap <= 0.0f)
+		{
+			return false;
+		}
+
+		if (!maze->findPath(PositionVector::START, PositionVector::FINISH, knownPath))
+		{
+			return false;
+		}
+
+		int optimisticMoves = getPathMoves(mappingPath);
+		int knownMoves = getPathMoves(knownPath);
+
+		log(DEBUG3) << "Known path " << knownMoves << " moves, mapping path " << optimisticMoves << " moves";
+
+		return knownMoves <= optimisticMoves * (1.0f + mappingGap);
+	}
+
+
+
 	void MouseBot::lookAround()
 	{
 		logC(DEBUG4) << "lookAround()";
@@ -262,43 +444,6 @@ namespace Micromouse
 
 
 
-	NodePair MouseBot::getClosestNodePair(NodePairList & nodePairList)
-	{
-		NodePair closestNodePair;
-		bool isClosestFirst;
-		int shortestDistance = NUM_NODES_H + NUM_NODES_W; // INT_MAX not defined on teensy
-		int distance;
-
-		// iterate through the nodePairs
-		for (NodePairList::iterator itr = nodePairList.begin(); itr != nodePairList.end(); ++itr)
-		{
-			//first of pair
-			distance = pow(itr->first->getPos().x() - position.x(), 2) + pow(itr->first->getPos().y() - position.y(), 2);
-
-			if ( distance < shortestDistance)
-			{
-				closestNodePair = *itr;
-				isClosestFirst = true;
-				shortestDistance = distance;
-			}
-
-			//second of pair
-			distance = pow(itr->second->getPos().x() - position.x(), 2) + pow(itr->second->getPos().y() - position.y(), 2);
-
-			if (distance < shortestDistance)
-			{
-				closestNodePair = *itr;
-				isClosestFirst = false;
-				shortestDistance = distance;
-			}
-		}
-
-		// make it so the closest node of the two always comes first
-		return isClosestFirst ? closestNodePair : std::make_pair( closestNodePair.second , closestNodePair.first );
-	}
-
-
-
 	bool MouseBot::isClearForward()
 	{
 #ifdef __MK20DX256__ // Teensy Compile
@@ -345,90 +490,103 @@ namespace Micromouse
 	void MouseBot::move(direction dir)
 	{
 		position = position + dir;
-		movementHistory.push(dir);
+		moves++;
 	}
 
 
 
-	void MouseBot::followPath(Path* path, bool keepPath)
+	void MouseBot::followPath(Path& path)
 	{
-		// make sure there is a path
-		if (path != nullptr)
-		{
-			DirectionVector dirVec(N, 0);
+		DirectionVector dirVec(N, 0);
 
-			// while there is still some path remaining
-			while (!path->empty())
-			{
-				BUTTONFLAG
-
-				// get the next step of the path
-				dirVec = path->popStep();
-
-				// follow the path
-				rotateToFaceDirection(dirVec.dir());
-				moveForward(dirVec.mag());
-			}
-		}
-		else
+		// while there is still some path remaining
+		while (!path.empty())
 		{
-			log(ERROR) << "COULD NOT FIND PATH DURING RUNNING";
-		}
+			BUTTONFLAG
 
-		BUTTONEXIT
+			// get the next step of the path
+			dirVec = path.popStep();
 
-		if ( !keepPath)
-		{
-			delete path;
+			// follow the path
+			rotateToFaceDirection(dirVec.dir());
+			moveForward(dirVec.mag());
 		}
 
+		BUTTONEXIT
 		return;
 	}
 
 
 
-	void MouseBot::followPathUntilBroken(Path * path, bool keepPath)
+	void MouseBot::runPath(Path& path)
 	{
-		// make sure there is a path
-		if (path != nullptr)
+		MotionCompiler compiler(path, facing, maze->getMotionModel());
+		MotionPrimitive primitive;
+
+		log(DEBUG1) << "Predicted run time: " << compiler.getTime() << "s, " << maze->getRunPathTime() << "s with a stop after every step";
+
+		while (compiler.next(primitive))
 		{
-			DirectionVector dirVec( N , 0 );
+			BUTTONFLAG
 
-			// while there is still some path remaining
-			while (!path->empty())
+#ifdef __MK20DX256__ // Teensy Compile
+			robotIO.execute(primitive);
+
+			// the same delays as moveForward and rotate, after the mouse stops
+			if (primitive.type == MotionPrimitive::TURN_IN_PLACE)
 			{
-				BUTTONFLAG
-	
-				// get the next step of the path
-				dirVec = path->popStep();
+				delay(200);
+			}
+			else if (primitive.type != MotionPrimitive::SWEPT_TURN && primitive.exitSpeed == 0.0f)
+			{
+				delay(500);
+			}
+#endif
 
-				lookAround();
-				// if the next step in the path is unobstructed
-				// then follow the path
-				if ( maze->getNeighborNode( position , dirVec.dir() ) != nullptr )
-				{
-					rotateToFaceDirection(dirVec.dir());
-					moveForward();
-				}
-				else // desired path was obstructed
-				{
-					goto EXIT;
-				}
+			facing = primitive.heading;
+
+			for (int i = 0; i < primitive.numNodes; i++)
+			{
+				move(facing);
 			}
 		}
-		else
-		{
-			log(ERROR) << "COULD NOT FIND PATH DURING MAPPING";
-		}
 
-		EXIT:
+		path.clear();
+
 		BUTTONEXIT
+		return;
+	}
 
-		if (!keepPath)
+
+
+	void MouseBot::followPathUntilBroken(Path& path)
+	{
+		DirectionVector dirVec( N , 0 );
+
+		// while there is still some path remaining
+		while (!path.empty())
 		{
-			delete path;
+			BUTTONFLAG
+	
+			// get the next step of the path
+			dirVec = path.popStep();
+
+			lookAround();
+			// if the next step in the path is unobstructed
+			// then follow the path
+			if ( maze->hasNeighborNode( position , dirVec.dir() ) )
+			{
+				rotateToFaceDirection(dirVec.dir());
+				moveForward();
+			}
+			else // desired path was obstructed
+			{
+				goto EXIT;
+			}
 		}
 
+		EXIT:
+		BUTTONEXIT
 		return;
 	}
 
@@ -475,6 +633,8 @@ namespace Micromouse
 #ifdef __MK20DX256__ // Teensy Compile
 		robotIO.moveForward(magnitude);
 		delay(500);
+#else // PC compile
+		simulateMotion(maze->getMotionModel().getStraightTime(numNodes, facing == NE || facing == SE || facing == SW || facing == NW));
 #endif
 	}
 
@@ -496,6 +656,8 @@ namespace Micromouse
 		case NW:	robotIO.rotate(-45);	break;
 		}
 		delay(200);
+#else // PC compile
+		simulateMotion(maze->getMotionModel().getTurnTime(dir));
 #endif
 	}
 
@@ -534,5 +696,43 @@ namespace Micromouse
 	{
 		robotIO.calibrateIRSensors();
 	}
-}
 
+
+
+#ifdef __MK20DX256__ // Teensy Compile
+#else // PC compile
+	void MouseBot::setMotionTimeScale(float scale)
+	{
+		motionTimeScale = scale;
+	}
+
+
+	void MouseBot::setAsyncPlanning(bool enabled)
+	{
+		if (enabled && plannerThread == nullptr)
+		{
+			plannerThread = new PlannerThread();
+		}
+		else if (!enabled)
+		{
+			delete plannerThread;
+			plannerThread = nullptr;
+		}
+	}
+
+
+	const PlannerThread* MouseBot::getPlannerThread() const
+	{
+		return plannerThread;
+	}
+
+
+	void MouseBot::simulateMotion(float seconds)
+	{
+		if (motionTimeScale > 0.0f)
+		{
+			std::this_thread::sleep_for(std::chrono::duration< float >(seconds * motionTimeScale));
+		}
+	}
+#endif
+}
\ No newline at end of file
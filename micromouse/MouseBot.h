@@ -9,20 +9,21 @@ Author GitHub:	joshuasrjc
 #include "Motor.h" //For some reason, this needs to be here for it to compile on Teensy.
 #include "Vector.h"
 #include "RobotIO.h"
-#include <stack>
 #include "Path.h"
 #include "Maze.h"
+#include "MotionModel.h"
+#include "MotionCompiler.h"
+#include "ExplorationPolicy.h"
 
 
 #ifdef __MK20DX256__ // Teensy Compile
 #else
 	#include "VirtualMaze.h"
+	#include "PlannerThread.h"
 #endif
 
 namespace Micromouse
 {
-	const float MM_PER_NODE = 90.0f;
-
 	//A class to be used for keeping track of the robot's position, as well as an interface to the I/O of the robot.
 	class MouseBot
 	{
@@ -36,6 +37,8 @@ namespace Micromouse
 		void setPos(PositionVector pos);		// Sets the position to pos
 		void resetToOrigin();
 
+		Maze& getMaze();						// Returns the mouse's map of the maze
+
 
 		//Maps out the maze. If on Teensey, it uses the sensors and motors to map a physical maze.
 		//Otherwise, it generates a random, virtual maze and uses it to simulate mapping.
@@ -43,6 +46,22 @@ namespace Micromouse
 		//Currently, the mouse ends in a random cell. Later, this function should return the mouse to the start.
 		int mapMaze();
 
+		//Sets the policy that chooses where mapMaze explores next, see ExplorationPolicy.
+		//The caller keeps ownership, nullptr restores the default NearestPassagePolicy.
+		void setExplorationPolicy(ExplorationPolicy* policy);
+
+		//Lets mapMaze stop early, once the shortest path from START to FINISH over explored nodes is at
+		//most 'gap' longer than the shortest mapping path, which counts unexplored nodes as open so no
+		//path in the maze is shorter. 0.05 stops when the known path is within 5% of the best possible.
+		//0, the default, maps until the shortest path is fully explored.
+		void setMappingGap(float gap);
+
+		//Maps out the maze with the classic modified flood fill, see ModifiedFloodFill.
+		//The mouse always moves to the neighbor nearest the goal, going between FINISH and START
+		//until the shortest path between them is explored, so each step only repairs the distances
+		//around the walls it just found. Returns the number of moves, like mapMaze.
+		int mapMazeFloodFill();
+
 		void runMaze();
 
 		void resetMaze();
@@ -69,31 +88,73 @@ namespace Micromouse
 
 		void CalibrateIRSensors();
 
+#ifdef __MK20DX256__ // Teensy Compile
+#else // PC compile
+		// The simulator moves instantly unless this is set. Every move and rotation then sleeps for 'scale'
+		// times the time the motion model predicts for it, so planning and driving can be timed together.
+		void setMotionTimeScale(float scale);
+
+		// When enabled, mapMaze plans the next START to FINISH query on a PlannerThread while the mouse
+		// follows each mapping path, and only plans after the path if the plan was stale. The planner is
+		// only used while the moves take time, see setMotionTimeScale. Disabled by default, since
+		// Benchmark::asyncPlanning has not shown it to be faster.
+		void setAsyncPlanning(bool enabled);
+
+		// returns the planner thread, or nullptr when async planning is disabled
+		const PlannerThread* getPlannerThread() const;
+#endif
+
 	private:
 		const int MAX_SPEED = 8;
 
 		void move(direction dir);
-		void followPath(Path* path, bool keepPath = false); 
-		void followPathUntilBroken(Path* path , bool keepPath = false); // used for mapping maze
+		void followPath(Path& path);
+		void followPathUntilBroken(Path& path); // used for mapping maze
+
+		// follows 'path' until it is broken, then finds the mapping path from START to FINISH
+		// into 'path' and its passages into nodePairList
+		void followPathAndReplan(Path& path);
+		void runPath(Path& path); // drives the path without stopping at every step, see MotionCompiler
 
 		void lookAround();
 
+		// returns the number of nodes moved by following 'path'
+		static int getPathMoves(const Path& path);
+
+		// returns true if the mapping gap is set and the shortest path over explored nodes
+		// is within it of 'mappingPath', the shortest mapping path from START to FINISH
+		bool isWithinMappingGap(const Path& mappingPath);
+
 
-		NodePair getClosestNodePair(NodePairList & nodePairList);
 
 		int moves = 0;
 
 		Maze* maze;
 
+		NearestPassagePolicy nearestPassagePolicy;
+		ExplorationPolicy* explorationPolicy = &nearestPassagePolicy;
+
+		float mappingGap = 0.0f;
+
+		// reused by every search so mapping and running do not allocate
+		Path path;
+		Path knownPath; // the path over explored nodes, when it is compared with the mapping path
+		NodePairList nodePairList;
+
 		int speed = 1;
 
 #ifdef __MK20DX256__ // Teensy Compile
 #else
 		VirtualMaze* virtualMaze;
+
+		// sleeps for 'seconds' times motionTimeScale
+		void simulateMotion(float seconds);
+
+		float motionTimeScale = 0.0f;
+		PlannerThread* plannerThread = nullptr;
 #endif
 		int saveAddress = 512;
 		RobotIO robotIO;
-		std::stack<direction> movementHistory;
 
 		// Mouse position in the maze
 		PositionVector position = PositionVector(0,0);
@@ -0,0 +1,220 @@
+#include "NodeHeap.h"
+#include <assert.h>
+
+
+
+
+namespace Micromouse
+{
+	NodeHeap::NodeHeap( int capacity ) :
+		capacity( capacity )
+	{
+		assert( capacity > 0 && capacity < NOT_IN_HEAP );
+
+		heap = new unsigned short[ capacity ];
+		position = new unsigned short[ capacity ];
+		keys = new int[ capacity ];
+
+		for ( int i = 0; i < capacity; i++ )
+		{
+			position[ i ] = NOT_IN_HEAP;
+		}
+	}
+
+
+
+	NodeHeap::~NodeHeap()
+	{
+		delete[] heap;
+		delete[] position;
+		delete[] keys;
+	}
+
+
+
+	void NodeHeap::push( int index , int key )
+	{
+		assert( index >= 0 && index < capacity );
+
+		if ( position[ index ] == NOT_IN_HEAP )
+		{
+			heap[ count ] = index;
+			position[ index ] = count;
+			keys[ index ] = key;
+
+			siftUp( count++ );
+		}
+		else if ( key < keys[ index ] )
+		{
+			keys[ index ] = key;
+			siftUp( position[ index ] );
+		}
+		else
+		{
+			keys[ index ] = key;
+			siftDown( position[ index ] );
+		}
+	}
+
+
+
+	int NodeHeap::pop()
+	{
+		assert( count > 0 );
+
+		int index = heap[ 0 ];
+		remove( index );
+
+		return index;
+	}
+
+
+
+	int NodeHeap::top() const
+	{
+		assert( count > 0 );
+
+		return heap[ 0 ];
+	}
+
+
+
+	int NodeHeap::topKey() const
+	{
+		assert( count > 0 );
+
+		return keys[ heap[ 0 ] ];
+	}
+
+
+
+	void NodeHeap::remove( int index )
+	{
+		assert( index >= 0 && index < capacity );
+
+		int pos = position[ index ];
+
+		if ( pos == NOT_IN_HEAP )
+		{
+			return;
+		}
+
+		position[ index ] = NOT_IN_HEAP;
+		count--;
+
+		// fill the hole with the last item and restore the heap from there
+		if ( pos != count )
+		{
+			int moved = heap[ count ];
+			heap[ pos ] = moved;
+			position[ moved ] = pos;
+
+			siftUp( pos );
+			siftDown( position[ moved ] );
+		}
+	}
+
+
+
+	bool NodeHeap::contains( int index ) const
+	{
+		return position[ index ] != NOT_IN_HEAP;
+	}
+
+
+
+	int NodeHeap::getKey( int index ) const
+	{
+		assert( contains( index ) );
+
+		return keys[ index ];
+	}
+
+
+
+	int NodeHeap::size() const
+	{
+		return count;
+	}
+
+
+
+	bool NodeHeap::empty() const
+	{
+		return count == 0;
+	}
+
+
+
+	void NodeHeap::clear()
+	{
+		for ( int i = 0; i < count; i++ )
+		{
+			position[ heap[ i ] ] = NOT_IN_HEAP;
+		}
+
+		count = 0;
+	}
+
+
+
+	void NodeHeap::siftUp( int pos )
+	{
+		int index = heap[ pos ];
+		int key = keys[ index ];
+
+		// move parents down until the spot for 'index' is found
+		while ( pos > 0 )
+		{
+			int parent = ( pos - 1 ) / 2;
+
+			if ( keys[ heap[ parent ] ] <= key )
+			{
+				break;
+			}
+
+			heap[ pos ] = heap[ parent ];
+			position[ heap[ pos ] ] = pos;
+			pos = parent;
+		}
+
+		heap[ pos ] = index;
+		position[ index ] = pos;
+	}
+
+
+
+	void NodeHeap::siftDown( int pos )
+	{
+		int index = heap[ pos ];
+		int key = keys[ index ];
+
+		// move the smaller child up until the spot for 'index' is found
+		for ( ;; )
+		{
+			int child = 2 * pos + 1;
+
+			if ( child >= count )
+			{
+				break;
+			}
+
+			if ( child + 1 < count && keys[ heap[ child + 1 ] ] < keys[ heap[ child ] ] )
+			{
+				child++;
+			}
+
+			if ( key <= keys[ heap[ child ] ] )
+			{
+				break;
+			}
+
+			heap[ pos ] = heap[ child ];
+			position[ heap[ pos ] ] = pos;
+			pos = child;
+		}
+
+		heap[ pos ] = index;
+		position[ index ] = pos;
+	}
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+
+
+namespace Micromouse
+{
+	// An indexed binary min-heap used as the open list for pathfinding.
+	// The items are node indices ( 0 <= index < capacity ) and each one is given
+	// an integer key. The heap stores the position of every index it holds so
+	// membership tests are O(1) and a key can be changed in O(log n) without
+	// searching through the heap.
+	class NodeHeap
+	{
+	public:
+		// 'capacity' is the number of distinct indices the heap can hold
+		NodeHeap( int capacity );
+		~NodeHeap();
+
+		// a copy would free the arrays it owns twice
+		NodeHeap( const NodeHeap& ) = delete;
+		NodeHeap& operator=( const NodeHeap& ) = delete;
+
+		// adds 'index' to the heap with the priority 'key'
+		// if 'index' is already in the heap its key is changed instead
+		void push( int index , int key );
+
+		// removes the index with the lowest key and returns it
+		// calling on an empty heap will result in an error
+		int pop();
+
+		// returns the index with the lowest key without removing it
+		// calling on an empty heap will result in an error
+		int top() const;
+
+		// returns the lowest key in the heap
+		// calling on an empty heap will result in an error
+		int topKey() const;
+
+		// removes 'index' from the heap if it is in the heap
+		void remove( int index );
+
+		// returns true if 'index' is currently in the heap
+		bool contains( int index ) const;
+
+		// returns the key of 'index', it must be in the heap
+		int getKey( int index ) const;
+
+		// returns the number of indices in the heap
+		int size() const;
+
+		// returns true when the heap is empty, false otherwise
+		bool empty() const;
+
+		// removes every index from the heap
+		// only the indices that are in the heap are touched
+		void clear();
+
+	private:
+		static const unsigned short NOT_IN_HEAP = 0xFFFF;
+
+		// moves the item at heap position 'pos' up or down until the heap is valid
+		void siftUp( int pos );
+		void siftDown( int pos );
+
+		int capacity;
+		int count = 0;
+
+		unsigned short* heap; // heap[ pos ] is the index stored at that position in the heap
+		unsigned short* position; // position[ index ] is where 'index' is in 'heap'
+		int* keys; // keys[ index ] is the priority of 'index'
+	};
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include "Vector.h"
+
+
+
+namespace Micromouse
+{
+	// Something kept from the nodes of a maze that has to hear about every change to them.
+	// MazeT::addListener registers one, after that addNode, removeNode and reset tell it about
+	// each change, and setExplored too if it asked for the explored nodes, so the maze does not
+	// need to know what each of the structures it keeps does with a change.
+	class NodeListener
+	{
+	public:
+		virtual ~NodeListener() {}
+
+		// called after the node at 'pos' was added, removed or explored
+		virtual void updateNode( PositionVector pos ) = 0;
+
+		// called after every node was removed from the maze
+		virtual void reset() = 0;
+	};
+}
@@ -6,54 +6,111 @@
 
 namespace Micromouse
 {
-	Path::Path()
+	template < int CAPACITY >
+	PathT< CAPACITY >::PathT() :
+		numSteps( 0 )
 	{
 	}
 
 
 
-	Path::~Path()
+	template < int CAPACITY >
+	PathT< CAPACITY >::PathT( const PathT& other ) :
+		numSteps( 0 )
 	{
+		*this = other;
 	}
 
 
-	void Path::addStep( DirectionVector step )
+
+	template < int CAPACITY >
+	PathT< CAPACITY >& PathT< CAPACITY >::operator=( const PathT& other )
 	{
-		path.push( step );
+		for ( int i = 0; i < other.numSteps; i++ )
+		{
+			steps[ i ] = other.steps[ i ];
+		}
+
+		numSteps = other.numSteps;
+
+		return *this;
 	}
 
 
 
-	DirectionVector Path::popStep()
+	template < int CAPACITY >
+	void PathT< CAPACITY >::addStep( DirectionVector step )
 	{
-		assert( !path.empty() );
+		assert( numSteps < CAPACITY );
+		assert( step.mag() <= MAG_MASK );
+
+		steps[ numSteps++ ] = static_cast< unsigned short >( ( step.dir() << MAG_BITS ) | step.mag() );
+	}
+
 
-		DirectionVector step = path.top();
-		path.pop();
+
+	template < int CAPACITY >
+	DirectionVector PathT< CAPACITY >::popStep()
+	{
+		DirectionVector step = peekStep();
+		numSteps--;
 
 		return step;
 	}
 
 
 
-	DirectionVector Path::peekStep()
+	template < int CAPACITY >
+	DirectionVector PathT< CAPACITY >::peekStep() const
+	{
+		assert( numSteps > 0 );
+
+		return getStep( 0 );
+	}
+
+
+
+	template < int CAPACITY >
+	DirectionVector PathT< CAPACITY >::getStep( int i ) const
 	{
-		assert( !path.empty() );
+		assert( i >= 0 && i < numSteps );
+
+		unsigned short step = steps[ numSteps - 1 - i ];
+
+		return DirectionVector( static_cast< direction >( step >> MAG_BITS ) , step & MAG_MASK );
+	}
+
 
-		return path.top();
+
+	template < int CAPACITY >
+	int PathT< CAPACITY >::size() const
+	{
+		return numSteps;
 	}
 
 
 
-	int Path::size()
+	template < int CAPACITY >
+	bool PathT< CAPACITY >::empty() const
 	{
-		return path.size();
+		return numSteps == 0;
 	}
 
 
 
-	bool Path::empty()
+	template < int CAPACITY >
+	void PathT< CAPACITY >::clear()
 	{
-		return path.empty();
+		numSteps = 0;
 	}
+
+
+
+	// the classic and the half size competition mazes, only the simulator builds the half size one
+	template class PathT< MazeGeometry< 16 , 16 >::MAX_PATH_STEPS >;
+
+#ifdef __MK20DX256__ // Teensy Compile
+#else // PC compile
+	template class PathT< MazeGeometry< 32 , 32 >::MAX_PATH_STEPS >;
+#endif
 }
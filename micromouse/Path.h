@@ -1,6 +1,6 @@
 #pragma once
-#include <stack>
 #include "Vector.h"
+#include "MazeGeometry.h"
 
 
 
@@ -9,15 +9,26 @@ namespace Micromouse
 	// This class represents the path the mouse should follow to reach the destination
 	// It consists of a stack of direction vectors that when executed in order will
 	// guide the mouse to the finish destination
-
-	class Path
+	//
+	// The steps are stored inside the object, so building and following a path never
+	// allocates. The caller owns the path and findPath fills it, see MazeT::findPath
+	// CAPACITY is the most steps the path can hold, see MazeGeometry::MAX_PATH_STEPS
+	template < int CAPACITY >
+	class PathT
 	{
 	public:
-		Path();
-		~Path();
+		// the most steps the path can hold
+		static const int MAX_STEPS = CAPACITY;
+
+		PathT();
+
+		// copying only copies the steps in use
+		PathT( const PathT& other );
+		PathT& operator=( const PathT& other );
 
 		// adds step to 'path'
 		// steps need to be added in reverse order
+		// adding more than MAX_STEPS steps will result in an error
 		void addStep( DirectionVector step );
 
 		// returns the next step in the path and removes it from the path
@@ -26,19 +37,33 @@ namespace Micromouse
 
 		// returns the next step in the path without removing it
 		// calling on an empty path will result in an error
-		DirectionVector peekStep();
+		DirectionVector peekStep() const;
+
+		// returns step 'i' without removing anything, counting from the next step
+		// getStep( 0 ) is peekStep(), 'i' must be less than size()
+		DirectionVector getStep( int i ) const;
 
 		//returns the number of steps in the path
-		int size();
+		int size() const;
 
 		// returns true when the path is empty, false otherwise;
-		bool empty();
+		bool empty() const;
+
+		// removes every step
+		void clear();
 
 	private:
+		// each step is packed into 16 bits, the direction above the magnitude
+		static const int MAG_BITS = 12;
+		static const unsigned short MAG_MASK = ( 1 << MAG_BITS ) - 1;
+
 		// a first in - last out (FILO) list of steps for motion control to follow
-		// it is a FILO list because the path is created in reverse
+		// it is a FILO list because the path is created in reverse, the next step is steps[ numSteps - 1 ]
 		// each step consist of a direction and magnitude to travel before continuing on to the next step
-		std::stack<DirectionVector> path;
+		unsigned short steps[ CAPACITY ];
+		int numSteps;
 	};
-}
 
+	// the path for the maze size the mouse is built for
+	typedef PathT< MazeGeometry< MAZE_W , MAZE_H >::MAX_PATH_STEPS > Path;
+}
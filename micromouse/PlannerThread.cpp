@@ -0,0 +1,285 @@
+#include "PlannerThread.h"
+
+#ifdef __MK20DX256__ // Teensy Compile
+#else // PC compile
+
+
+
+namespace Micromouse
+{
+	PlannerThread::PlannerThread() :
+		worker( &PlannerThread::run , this )
+	{
+	}
+
+
+
+	PlannerThread::~PlannerThread()
+	{
+		{
+			std::lock_guard< std::mutex > lock( mutex );
+			stopping = true;
+			exiting = true;
+		}
+
+		wake.notify_all();
+		worker.join();
+	}
+
+
+
+	void PlannerThread::plan( const Maze& maze , PositionVector start , const Maze::Path& path )
+	{
+		std::unique_lock< std::mutex > lock( mutex );
+
+		stop( lock );
+
+		// the settings that change the mapping query
+		if ( planningMaze.getSearchEngine() != maze.getSearchEngine() )
+		{
+			planningMaze.setSearchEngine( maze.getSearchEngine() );
+		}
+
+		if ( planningMaze.getHeuristic() != maze.getHeuristic() )
+		{
+			planningMaze.setHeuristic( maze.getHeuristic() );
+		}
+
+		if ( planningMaze.getIncrementalPlanning() != maze.getIncrementalPlanning() )
+		{
+			planningMaze.setIncrementalPlanning( maze.getIncrementalPlanning() );
+		}
+
+		// the worker copies the nodes, so the mouse only waits for the snapshot
+		nodes = maze.getNodes();
+		exploredNodes = maze.getExploredNodes();
+
+		// no wall first, then every node the mouse has not seen yet, in the order it reaches them
+		numGuesses = 0;
+		guesses[ numGuesses++ ] = -1;
+
+		int x = start.x();
+		int y = start.y();
+
+		for ( int i = 0; i < path.size() && numGuesses <= MAX_GUESSES; i++ )
+		{
+			DirectionVector step = path.getStep( i );
+
+			for ( int j = 0; j < step.mag() && numGuesses <= MAX_GUESSES; j++ )
+			{
+				x += Maze::Geometry::DX[ step.dir() ];
+				y += Maze::Geometry::DY[ step.dir() ];
+
+				if ( !maze.isExplored( PositionVector( x , y ) ) )
+				{
+					guesses[ numGuesses++ ] = Maze::Geometry::getIndex( x , y );
+				}
+			}
+		}
+
+		numPlanned = 0;
+		pending = true;
+		planning = true;
+		lock.unlock();
+
+		wake.notify_all();
+	}
+
+
+
+	bool PlannerThread::takePlan( const Maze& maze , Maze::Path& path , NodePairList& passageNodes )
+	{
+		std::unique_lock< std::mutex > lock( mutex );
+
+		if ( !pending )
+		{
+			return false;
+		}
+
+		pending = false;
+		plans++;
+
+		// the mouse stops at the first wall on its path, so only the plan for the first guessed wall
+		// that is gone, or for no wall if none is, can be valid, and it is checked before anything waits
+		int g = 0;
+
+		for ( int i = 1; i < numGuesses && g == 0; i++ )
+		{
+			if ( !maze.hasNode( getPos( guesses[ i ] ) ) )
+			{
+				g = i;
+			}
+		}
+
+		// the worker only writes the plans after the ones it finished, so it is not waited for,
+		// it stops after its current search and plan() waits for that
+		stopping = planning;
+
+		if ( g >= numPlanned || !found[ g ] || !isPathClear( maze , plannedPaths[ g ] ) )
+		{
+			stalePlans++;
+			return false;
+		}
+
+		path = plannedPaths[ g ];
+
+		// the same passages createPath finds, walking back from FINISH, whose first node counts as explored
+		bool wasExplored = true;
+		int exitNode = numPathNodes - 1;
+
+		for ( int i = numPathNodes - 2; i >= 0; i-- )
+		{
+			bool explored = maze.isExplored( getPos( pathNodes[ i ] ) );
+
+			if ( explored != wasExplored )
+			{
+				if ( wasExplored )
+				{
+					exitNode = i + 1;
+				}
+				else
+				{
+					passageNodes.push_back( std::make_pair( getPos( pathNodes[ i ] ) , getPos( pathNodes[ exitNode ] ) ) );
+				}
+			}
+
+			wasExplored = explored;
+		}
+
+		return true;
+	}
+
+
+
+	unsigned long PlannerThread::getPlans() const
+	{
+		return plans;
+	}
+
+
+
+	unsigned long PlannerThread::getStalePlans() const
+	{
+		return stalePlans;
+	}
+
+
+
+	const MazeBase::SearchStats& PlannerThread::getSearchStats() const
+	{
+		std::unique_lock< std::mutex > lock( mutex );
+
+		// takePlan() does not wait for the search the worker was running
+		while ( planning )
+		{
+			wake.wait( lock );
+		}
+
+		return planningMaze.getSearchStats();
+	}
+
+
+
+	void PlannerThread::run()
+	{
+		std::unique_lock< std::mutex > lock( mutex );
+
+		for ( ;; )
+		{
+			while ( !planning && !exiting )
+			{
+				wake.wait( lock );
+			}
+
+			if ( exiting )
+			{
+				return;
+			}
+
+			// plan() and getSearchStats() wait while planning, takePlan() only reads the plans before numPlanned
+			lock.unlock();
+			planningMaze.copyNodes( nodes , exploredNodes );
+			lock.lock();
+
+			while ( numPlanned < numGuesses && !stopping )
+			{
+				int g = numPlanned;
+				lock.unlock();
+
+				PositionVector wall = guesses[ g ] >= 0 ? getPos( guesses[ g ] ) : PositionVector( 0 , 0 );
+
+				if ( guesses[ g ] >= 0 )
+				{
+					planningMaze.removeNode( wall );
+				}
+
+				found[ g ] = planningMaze.findPath( PositionVector::START , PositionVector::FINISH , plannedPaths[ g ] , true );
+
+				// the next guess is planned without this wall
+				if ( guesses[ g ] >= 0 )
+				{
+					planningMaze.addNode( wall );
+				}
+
+				lock.lock();
+				numPlanned++;
+			}
+
+			planning = false;
+			wake.notify_all();
+		}
+	}
+
+
+
+	void PlannerThread::stop( std::unique_lock< std::mutex >& lock )
+	{
+		stopping = true;
+
+		while ( planning )
+		{
+			wake.wait( lock );
+		}
+
+		stopping = false;
+	}
+
+
+
+	bool PlannerThread::isPathClear( const Maze& maze , const Maze::Path& path )
+	{
+		int x = PositionVector::START.x();
+		int y = PositionVector::START.y();
+
+		numPathNodes = 0;
+		pathNodes[ numPathNodes++ ] = Maze::Geometry::getIndex( x , y );
+
+		for ( int i = 0; i < path.size(); i++ )
+		{
+			DirectionVector step = path.getStep( i );
+
+			for ( int j = 0; j < step.mag(); j++ )
+			{
+				x += Maze::Geometry::DX[ step.dir() ];
+				y += Maze::Geometry::DY[ step.dir() ];
+
+				if ( !maze.hasNode( PositionVector( x , y ) ) )
+				{
+					return false;
+				}
+
+				pathNodes[ numPathNodes++ ] = Maze::Geometry::getIndex( x , y );
+			}
+		}
+
+		return true;
+	}
+
+
+
+	PositionVector PlannerThread::getPos( int index )
+	{
+		return PositionVector( index / Maze::NUM_NODES_H , index % Maze::NUM_NODES_H );
+	}
+}
+#endif
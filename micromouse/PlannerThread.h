@@ -0,0 +1,106 @@
+#pragma once
+#include "Maze.h"
+
+#ifdef __MK20DX256__ // Teensy Compile
+#else
+	#include <thread>
+	#include <mutex>
+	#include <condition_variable>
+#endif
+
+
+
+namespace Micromouse
+{
+#ifdef __MK20DX256__ // Teensy Compile
+#else // PC compile
+	// Plans the next START to FINISH mapping query on a worker thread while the mouse drives,
+	// for MouseBot::mapMaze in the simulator.
+	//
+	// The mapping query counts unexplored nodes as open, so only the walls the mouse finds change it.
+	// A mapping path usually ends at the first wall across it, so plan() guesses each unexplored node
+	// on the path the mouse is about to follow as that wall, and the worker plans for each guess in
+	// turn on its own copy of the maze, starting with the guess of no wall, while the mouse moves.
+	//
+	// The mouse stops at the first wall on its path, so takePlan() knows from the real maze which guess
+	// it needs before it looks at any plan. The real maze only lost nodes compared to the maze that
+	// guess was planned on, so if every node of its plan is still there no shorter path can exist and
+	// the plan is used. If the worker has not planned that guess yet, or a wall the guess missed is on
+	// the plan, the plans are thrown away without waiting for the worker.
+	class PlannerThread
+	{
+	public:
+		// the most walls guessed for one path
+		static const int MAX_GUESSES = 16;
+
+		// starts the worker, it waits for plan()
+		PlannerThread();
+
+		// stops the worker and waits for it
+		~PlannerThread();
+
+		// starts planning for the walls the mouse may find following 'path' from 'start' in 'maze'
+		// stops the previous plans first if they were never taken
+		void plan( const Maze& maze , PositionVector start , const Maze::Path& path );
+
+		// tells the worker to stop, then if the plan for the wall the mouse found in 'maze' is ready and
+		// valid copies its mapping path from START to FINISH into 'path', adds its passages between the
+		// explored nodes of 'maze' to 'passageNodes', like Maze::findPath, and returns true
+		// returns false if that plan is stale or no plan was started
+		bool takePlan( const Maze& maze , Maze::Path& path , NodePairList& passageNodes );
+
+		// the number of times takePlan() was called after plan(), and of those the ones where every plan was stale
+		unsigned long getPlans() const;
+		unsigned long getStalePlans() const;
+
+		// the counters of the searches run by the worker, waits for the search it is running
+		const MazeBase::SearchStats& getSearchStats() const;
+
+	private:
+		// the worker's loop, it plans for each guess until it runs out of guesses or is stopped
+		void run();
+
+		// stops the worker and waits for the search it is running, 'lock' must hold the mutex
+		void stop( std::unique_lock< std::mutex >& lock );
+
+		// returns true if every node of 'path' from START is in 'maze', and fills 'pathNodes' with them
+		bool isPathClear( const Maze& maze , const Maze::Path& path );
+
+		// returns the position of the node at 'index'
+		static PositionVector getPos( int index );
+
+		Maze planningMaze;
+
+		// the nodes of the mouse's maze when plan() was called, the worker copies them into the planning maze
+		BitBoard nodes;
+		BitBoard exploredNodes;
+
+		// the node each plan guessed as the wall, -1 for no wall
+		int guesses[ MAX_GUESSES + 1 ];
+		int numGuesses = 0;
+
+		// the plans for the guesses, the worker fills them in order
+		Maze::Path plannedPaths[ MAX_GUESSES + 1 ];
+		bool found[ MAX_GUESSES + 1 ];
+		int numPlanned = 0;
+
+		// the indices of the nodes of the plan being checked from START, used to find its passages
+		unsigned short pathNodes[ Maze::Path::MAX_STEPS + 1 ];
+		int numPathNodes = 0;
+
+		unsigned long plans = 0;
+		unsigned long stalePlans = 0;
+
+		// the worker only touches the planning maze, the snapshot and the plans from numPlanned on
+		// while planning is true, the plans before numPlanned are done and can be read
+		mutable std::mutex mutex;
+		mutable std::condition_variable wake;
+		bool pending = false; // plan() was called and takePlan() was not
+		bool planning = false;
+		bool stopping = false; // the worker stops after its current search
+		bool exiting = false; // the worker thread returns
+
+		std::thread worker;
+	};
+#endif
+}
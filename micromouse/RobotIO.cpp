@@ -1,4 +1,6 @@
 #include "RobotIO.h"
+#include <math.h>
+#include <stdlib.h>
 #include "IRSensor.h"
 #include "Vector.h"
 #include "Logger.h"
@@ -69,11 +71,33 @@ namespace Micromouse
 
 
 
-	void RobotIO::followPath(Path * path)
+	void RobotIO::execute(const MotionPrimitive& primitive)
 	{
-		// TODO implement
+		// Drives stop and go: moveForward and rotate start and end stopped, so the entry and exit
+		// speeds of the primitive are not followed, and a swept turn is driven as the corner its
+		// arc cuts, which ends in the same place. The robot is slower than MotionCompiler::getTime.
+		switch (primitive.type)
+		{
+		case MotionPrimitive::STRAIGHT:
+		case MotionPrimitive::DIAGONAL:
+			moveForward(primitive.distance);
+			break;
+
+		case MotionPrimitive::TURN_IN_PLACE:
+			rotate(primitive.degrees);
+			break;
+
+		case MotionPrimitive::SWEPT_TURN:
+		{
+			float radians = abs(primitive.degrees) * PI / 180.0f;
+			float cut = primitive.distance / radians * tanf(radians / 2.0f);
 
-		delete path;
+			moveForward(cut);
+			rotate(primitive.degrees);
+			moveForward(cut);
+			break;
+		}
+		}
 	}
 
 
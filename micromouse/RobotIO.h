@@ -4,7 +4,7 @@
 #include "IRSensor.h"
 #include "PIDController.h"
 #include "Vector.h"
-#include "Path.h"
+#include "MotionCompiler.h"
 
 
 namespace Micromouse
@@ -84,7 +84,8 @@ namespace Micromouse
 		bool isClearRight(); // Returns false if the range-finder sensors detect a wall to the right of the bot. Otherwise, returns true.
 		bool isClearLeft(); // Returns false if the range-finder sensors detect a wall to the left of the bot. Otherwise, returns true.
 
-		void followPath(Path * path);
+		//Drives one primitive of a compiled path, see MotionCompiler. Stops after every primitive.
+		void execute(const MotionPrimitive& primitive);
 
 		void calibrateIRSensors();
 
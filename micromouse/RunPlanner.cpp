@@ -0,0 +1,312 @@
+#include "RunPlanner.h"
+#include "Maze.h"
+#include <assert.h>
+
+
+
+
+namespace Micromouse
+{
+	// returns the number of 45 degree steps in the rotation 'turn', turning either way
+	static int getTurnSteps( direction turn )
+	{
+		return turn <= S ? turn : 8 - turn;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	RunPlannerT< WIDTH , HEIGHT >::RunPlannerT( const MazeT< WIDTH , HEIGHT >& maze , NodeHeap& openList ) :
+		maze( maze ),
+		openList( openList )
+	{
+		time = new unsigned short[ NUM_STATES ];
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	RunPlannerT< WIDTH , HEIGHT >::~RunPlannerT()
+	{
+		delete[] time;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	bool RunPlannerT< WIDTH , HEIGHT >::findPath( PositionVector start , direction facing , PositionVector end , const MotionModel& model , Path& path , unsigned long& nodesExpanded , const Board* skipped )
+	{
+		assert( facing != NONE );
+
+		path.clear();
+		lastPathTicks = 0;
+		this->skipped = skipped;
+
+		if ( start == end )
+		{
+			return true;
+		}
+
+		computeTicks( model );
+
+		for ( int i = 0; i < NUM_STATES; i++ )
+		{
+			time[ i ] = NO_TIME;
+		}
+
+		openList.clear();
+
+		int startIndex = Geometry::getIndex( start.x() , start.y() );
+		int endIndex = Geometry::getIndex( end.x() , end.y() );
+
+		// the first straight can go any way after rotating from 'facing'
+		for ( int d = 0; d < NUM_HEADINGS; d++ )
+		{
+			direction dir = static_cast< direction >( d );
+
+			relaxStraight( startIndex , dir , turnTicks[ getTurnSteps( dir - facing ) ] );
+		}
+
+		while ( !openList.empty() )
+		{
+			int key = openList.topKey();
+			int index = openList.pop();
+
+			if ( index == endIndex )
+			{
+				for ( int h = 0; h < NUM_HEADINGS; h++ )
+				{
+					int state = getState( index , static_cast< direction >( h ) );
+
+					if ( time[ state ] == key )
+					{
+						if ( !createPath( state , startIndex , facing , path ) )
+						{
+							return false;
+						}
+
+						lastPathTicks = key;
+						return true;
+					}
+				}
+			}
+
+			// expand the states of the node with the lowest time, the node goes back
+			// on the open list if it has other states that were reached later
+			int nextKey = NO_TIME;
+
+			for ( int h = 0; h < NUM_HEADINGS; h++ )
+			{
+				direction heading = static_cast< direction >( h );
+				int stateTime = time[ getState( index , heading ) ];
+
+				if ( stateTime == key )
+				{
+					nodesExpanded++;
+
+					for ( int d = 0; d < NUM_HEADINGS; d++ )
+					{
+						direction dir = static_cast< direction >( d );
+
+						if ( dir != heading && dir != heading + S )
+						{
+							relaxStraight( index , dir , key + turnTicks[ getTurnSteps( dir - heading ) ] );
+						}
+					}
+				}
+				else if ( stateTime > key && stateTime < nextKey )
+				{
+					nextKey = stateTime;
+				}
+			}
+
+			if ( nextKey != NO_TIME )
+			{
+				openList.push( index , nextKey );
+			}
+		}
+
+		return false;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	float RunPlannerT< WIDTH , HEIGHT >::getPathTime() const
+	{
+		return lastPathTicks / static_cast< float >( TICKS_PER_SECOND );
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	int RunPlannerT< WIDTH , HEIGHT >::getState( int index , direction heading )
+	{
+		return index * NUM_HEADINGS + heading;
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	int RunPlannerT< WIDTH , HEIGHT >::toTicks( float seconds )
+	{
+		return static_cast< int >( seconds * TICKS_PER_SECOND + 0.5f );
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	void RunPlannerT< WIDTH , HEIGHT >::computeTicks( const MotionModel& model )
+	{
+		for ( int numNodes = 0; numNodes <= MAX_STRAIGHT; numNodes++ )
+		{
+			straightTicks[ numNodes ] = toTicks( model.getStraightTime( numNodes ) );
+			diagonalTicks[ numNodes ] = toTicks( model.getStraightTime( numNodes , true ) );
+		}
+
+		for ( int steps = 0; steps <= 4; steps++ )
+		{
+			turnTicks[ steps ] = toTicks( model.getTurnTime( static_cast< direction >( steps ) ) );
+		}
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	int RunPlannerT< WIDTH , HEIGHT >::getNextNode( int index , direction dir ) const
+	{
+		return dir % 2 == 0 ? maze.getNeighborIndex( index , dir ) : maze.getDiagonalNeighborIndex( index , dir );
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	bool RunPlannerT< WIDTH , HEIGHT >::isExplored( int index ) const
+	{
+		int x = index / Geometry::NUM_NODES_H;
+		int y = index % Geometry::NUM_NODES_H;
+
+		return maze.nodeExplored.getUnchecked( x , y ) && ( skipped == nullptr || !skipped->getUnchecked( x , y ) );
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	int RunPlannerT< WIDTH , HEIGHT >::getStraightTicks( direction dir , int numNodes ) const
+	{
+		return dir % 2 == 0 ? straightTicks[ numNodes ] : diagonalTicks[ numNodes ];
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	void RunPlannerT< WIDTH , HEIGHT >::relaxStraight( int index , direction dir , int baseTime )
+	{
+		int node = index;
+
+		for ( int numNodes = 1; numNodes <= MAX_STRAIGHT; numNodes++ )
+		{
+			node = getNextNode( node , dir );
+
+			if ( node == MazeT< WIDTH , HEIGHT >::NO_NODE || !isExplored( node ) )
+			{
+				return; // the straight ends at a wall or at the unexplored part of the maze
+			}
+
+			int newTime = baseTime + getStraightTicks( dir , numNodes );
+
+			if ( newTime >= NO_TIME )
+			{
+				return; // a longer straight would take even longer
+			}
+
+			int state = getState( node , dir );
+
+			if ( newTime < time[ state ] )
+			{
+				time[ state ] = newTime;
+
+				if ( !openList.contains( node ) || newTime < openList.getKey( node ) )
+				{
+					openList.push( node , newTime );
+				}
+			}
+		}
+	}
+
+
+
+	template < int WIDTH , int HEIGHT >
+	bool RunPlannerT< WIDTH , HEIGHT >::createPath( int state , int startIndex , direction facing , Path& path ) const
+	{
+		// there is no parent array, instead each straight is found by walking back from the
+		// end of the straight until a state there has exactly the time it would need
+		// every reached state has such a straight, and the time falls with each one so this stops
+		// a start that is not a node of the maze can be left but not walked back to, then no straight
+		// is found and the path fails instead of the walk looping
+		for ( ;; )
+		{
+			int index = state / NUM_HEADINGS;
+			direction heading = static_cast< direction >( state % NUM_HEADINGS );
+
+			bool found = false;
+			int node = index;
+
+			for ( int numNodes = 1; numNodes <= MAX_STRAIGHT && !found; numNodes++ )
+			{
+				node = getNextNode( node , heading + S );
+
+				if ( node == MazeT< WIDTH , HEIGHT >::NO_NODE )
+				{
+					break;
+				}
+
+				// the time when the mouse started this straight
+				int startTime = time[ state ] - getStraightTicks( heading , numNodes );
+
+				if ( node == startIndex && turnTicks[ getTurnSteps( heading - facing ) ] == startTime )
+				{
+					// this is the first straight
+					path.addStep( DirectionVector( heading , numNodes ) );
+					return true;
+				}
+
+				if ( !isExplored( node ) )
+				{
+					break;
+				}
+
+				for ( int h = 0; h < NUM_HEADINGS; h++ )
+				{
+					direction previous = static_cast< direction >( h );
+					int previousState = getState( node , previous );
+
+					if ( previous != heading && previous != heading + S && time[ previousState ] != NO_TIME &&
+						time[ previousState ] + turnTicks[ getTurnSteps( heading - previous ) ] == startTime )
+					{
+						path.addStep( DirectionVector( heading , numNodes ) );
+						state = previousState;
+						found = true;
+						break;
+					}
+				}
+			}
+
+			if ( !found )
+			{
+				path.clear();
+				return false;
+			}
+		}
+	}
+
+
+
+	// the classic and the half size competition mazes, only the simulator builds the half size one
+	template class RunPlannerT< 16 , 16 >;
+
+#ifdef __MK20DX256__ // Teensy Compile
+#else // PC compile
+	template class RunPlannerT< 32 , 32 >;
+#endif
+}
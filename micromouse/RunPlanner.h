@@ -0,0 +1,111 @@
+#pragma once
+#include "Vector.h"
+#include "NodeHeap.h"
+#include "MazeGeometry.h"
+#include "BitBoard.h"
+#include "MotionModel.h"
+#include "Path.h"
+
+
+
+namespace Micromouse
+{
+	template < int WIDTH , int HEIGHT > class MazeT;
+
+	// Plans the speed run, finding the path over explored nodes with the lowest time
+	// predicted by a MotionModel instead of the fewest nodes.
+	//
+	// The mouse stops after every straight and rotates before the next one, so the search
+	// state is a node and the heading the mouse arrived with, and each edge is a whole
+	// straight plus the rotation before it. Straights can be diagonal where the maze allows
+	// it, see MazeT::getDiagonalNeighborIndex. One long straight is always faster than two
+	// shorter ones with a stop between them, so a straight never continues the heading
+	// before it, and never reverses it.
+	//
+	// The open list holds nodes rather than states, keyed by the lowest time of their states
+	// that have not been expanded. The maze lends its NodeHeap, which is idle during a run.
+	template < int WIDTH , int HEIGHT >
+	class RunPlannerT
+	{
+	public:
+		typedef MazeGeometry< WIDTH , HEIGHT > Geometry;
+		typedef PathT< Geometry::MAX_PATH_STEPS > Path;
+		typedef BitBoardT< WIDTH , HEIGHT > Board;
+
+		// 'openList' must hold every node index of 'maze'
+		RunPlannerT( const MazeT< WIDTH , HEIGHT >& maze , NodeHeap& openList );
+		~RunPlannerT();
+
+		// a copy would free the arrays it owns twice
+		RunPlannerT( const RunPlannerT& ) = delete;
+		RunPlannerT& operator=( const RunPlannerT& ) = delete;
+
+		// finds the fastest path from 'start' to 'end' for a mouse at 'start' facing 'facing'
+		// and writes it into 'path', every step is one straight
+		// returns false and leaves 'path' empty if there is no path
+		// 'nodesExpanded' is increased by the number of states expanded
+		// the straights stop before the nodes in 'skipped', it may be nullptr
+		bool findPath( PositionVector start , direction facing , PositionVector end , const MotionModel& model , Path& path , unsigned long& nodesExpanded , const Board* skipped );
+
+		// returns the predicted time in seconds of the last path found
+		float getPathTime() const;
+
+	private:
+		// a state is a node index and the heading the mouse arrived with, see getState()
+		static const int NUM_HEADINGS = 8;
+		static const int NUM_STATES = NUM_HEADINGS * Geometry::NUM_NODES;
+
+		// the longest straight in nodes
+		static const int MAX_STRAIGHT = ( Geometry::NUM_NODES_W > Geometry::NUM_NODES_H ? Geometry::NUM_NODES_W : Geometry::NUM_NODES_H ) - 1;
+
+		// times are searched as whole ticks, short enough for the rounding not to matter
+		// and long enough for every path time to fit in an unsigned short
+		static const int TICKS_PER_SECOND = 100;
+
+		// the time of a state that has not been reached, paths that would take longer are ignored
+		static const unsigned short NO_TIME = 0xFFFF;
+
+		static int getState( int index , direction heading );
+
+		static int toTicks( float seconds );
+
+		// fills the tick tables from 'model'
+		void computeTicks( const MotionModel& model );
+
+		// returns the node after 'index' in the direction 'dir', or NO_NODE if the move is blocked
+		int getNextNode( int index , direction dir ) const;
+
+		// returns true if the node at 'index' has been explored and is not skipped
+		bool isExplored( int index ) const;
+
+		// returns the ticks of a straight of 'numNodes' nodes in the direction 'dir'
+		int getStraightTicks( direction dir , int numNodes ) const;
+
+		// reaches every node on the straight from 'index' in the direction 'dir'
+		// 'baseTime' is the time at 'index' including the rotation to 'dir'
+		void relaxStraight( int index , direction dir , int baseTime );
+
+		// fills 'path' by working backwards from 'state' to the start
+		// returns false and clears 'path' if no straight leads back from a state
+		bool createPath( int state , int startIndex , direction facing , Path& path ) const;
+
+		const MazeT< WIDTH , HEIGHT >& maze;
+
+		NodeHeap& openList;
+
+		unsigned short* time; // time[ state ] is the lowest predicted time found from start in ticks
+
+		// the ticks of a straight and a diagonal of each length and of a rotation by each number of 45 degree steps
+		int straightTicks[ MAX_STRAIGHT + 1 ];
+		int diagonalTicks[ MAX_STRAIGHT + 1 ];
+		int turnTicks[ 5 ];
+
+		int lastPathTicks = 0;
+
+		// the nodes the current search skips, or nullptr
+		const Board* skipped = nullptr;
+	};
+
+	// the planner for the maze size the mouse is built for
+	typedef RunPlannerT< MAZE_W , MAZE_H > RunPlanner;
+}
@@ -1,4 +1,5 @@
 #include "Vector.h"
+#include "MazeGeometry.h"
 #include <assert.h>
 
 namespace Micromouse
@@ -29,16 +30,7 @@ namespace Micromouse
 
 	bool isValidPosition(int x, int y)
 	{
-		if (x < 0 || x >= NUM_NODES_H || y < 0 || y >= NUM_NODES_H)
-		{
-			// false because it is outsite the maze
-			return false;
-		}
-		else
-		{
-			// false if at pos with two odd coordinates, unless at cetner of maze
-			return (x % 2 == 0) || (y % 2 == 0) || (x >= MAZE_W - 2 && y >= MAZE_H - 2 && x <= MAZE_W && y <= MAZE_H );
-		}
+		return MazeGeometry< MAZE_W , MAZE_H >::isValidPosition( x , y );
 	}
 
 
@@ -216,6 +208,6 @@ namespace Micromouse
 		assert( _dir != NONE );
 		assert( _mag >= 0 );
 
-		assert( _mag < NUM_NODES_W || _mag < NUM_NODES_H );
+		assert( _mag < MAX_MAZE_W * 2 - 1 || _mag < MAX_MAZE_H * 2 - 1 );
 	}
 }
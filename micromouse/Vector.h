@@ -10,6 +10,9 @@ namespace Micromouse
 	//number of nodes used to represent the maze
 	const int NUM_NODES_W = MAZE_W * 2 - 1 , NUM_NODES_H = MAZE_H * 2 - 1; 
 
+	//largest number of cells in any maze the simulator can build, see MazeGeometry.h
+	const int MAX_MAZE_W = 32, MAX_MAZE_H = 32;
+
 
 	/* defines directions 0-8, with 4 being NONE
 	it is done this way to make converting from direction to coordinates easier